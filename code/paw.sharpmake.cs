@@ -537,6 +537,25 @@ public class CoreTestsProject : TestsProjectBase
 	}
 }
 
+[Generate]
+public class CoreBenchmarksProject : PawProject
+{
+	public CoreBenchmarksProject() : base()
+	{
+		Name = "core-benchmarks";
+	}
+
+	[Configure]
+	public override void ConfigureAll(Project.Configuration conf, CustomTarget target)
+	{
+		base.ConfigureAll(conf, target);
+		conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+		conf.Output = Configuration.OutputType.Exe;
+		conf.AddPrivateDependency<CoreProject>(target);
+	}
+}
+
 
 [Generate]
 public class TestingProject : PawProject
@@ -659,6 +678,7 @@ public class PawSolution : Solution
 		conf.PlatformName = target.Platform.ToString();
 		conf.AddProject<ReflectStandaloneProject>(target);
 		conf.AddProject<CoreTestsProject>(target);
+		conf.AddProject<CoreBenchmarksProject>(target);
 		conf.AddProject<PresentationProject>(target);
 		conf.AddProject<ShaderProject>(target);
 	}
@@ -0,0 +1,704 @@
+#include "benchmark.h"
+
+#include <core/arena.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/slab.h>
+#include <core/tlsf.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#define PAW_BENCHMARK_MODULE_NAME Allocators
+
+// Every series runs one allocator on 1..N threads, each thread with its own instance since none of them are thread
+// safe. A sample is one batch of allocs and frees, reported as ns per Alloc/Free call. Batches end with the allocator's
+// natural reset, FreeAll for the arenas and freeing whatever is still live for TLSF and malloc, which is timed too.
+// After the last batch the memory is kept live so committed bytes and RSS reflect the peak. Fragmentation is the part of
+// that footprint that was never live at the same time, 1 - peak live bytes / committed bytes.
+
+enum class AllocatorKind : U8
+{
+	FixedSizeArena,
+	PagedArena,
+	Arena,
+	TLSF,
+	System,
+	Count,
+};
+
+static char const* const g_allocator_kind_names[]{
+	"FixedSizeArena",
+	"PagedArena",
+	"Arena",
+	"TLSF",
+	"malloc",
+};
+
+enum class FreeOrder : U8
+{
+	// Everything is allocated, then freed in allocation order
+	FIFO,
+	// Everything is allocated, then freed in reverse
+	LIFO,
+	// Every alloc has a 50% chance of being followed by freeing a random live allocation
+	Interleaved,
+	Count,
+};
+
+static char const* const g_free_order_names[]{
+	"fifo",
+	"lifo",
+	"interleaved",
+};
+
+struct SizeDistribution
+{
+	char const* name;
+	PtrSize min_size_bytes;
+	PtrSize max_size_bytes;
+	// Sizes are picked log-uniformly between min and max, so small sizes aren't drowned out in wide ranges
+	S32 allocation_count;
+	S32 max_iteration_count;
+};
+
+static constexpr PtrSize g_alignment = 16;
+static constexpr S32 g_thread_counts[]{1, 2, 4, 8};
+static constexpr S32 g_max_thread_count = 8;
+
+class SystemAllocator final : public IAllocator
+{
+public:
+	MemorySlice Alloc(PtrSize size_bytes, PtrSize /*alignment*/) override
+	{
+		// malloc already aligns to 16 on every platform we build for
+		return {static_cast<Byte*>(std::malloc(size_bytes)), size_bytes};
+	}
+
+	void Free(MemorySlice memory) override
+	{
+		std::free(memory.ptr);
+	}
+};
+
+struct BenchmarkRandom
+{
+	U64 state;
+
+	U64 Next()
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		return state >> 16;
+	}
+
+	PtrSize NextLogUniform(PtrSize min_value, PtrSize max_value)
+	{
+		if (min_value == max_value)
+		{
+			return min_value;
+		}
+
+		S32 const min_bit = 63 - __builtin_clzll(min_value);
+		S32 const max_bit = 63 - __builtin_clzll(max_value);
+		S32 const bit = min_bit + static_cast<S32>(Next() % static_cast<U64>(max_bit - min_bit + 1));
+		PtrSize const low = PtrSize(1) << bit;
+		PtrSize const value = low + Next() % low;
+		return value < min_value ? min_value : (value > max_value ? max_value : value);
+	}
+};
+
+// size_bytes == 0 frees the allocation in slot_index, anything else allocates into it
+struct AllocatorOp
+{
+	S32 slot_index;
+	PtrSize size_bytes;
+};
+
+struct Schedule
+{
+	Slice<AllocatorOp> ops;
+	S32 slot_count = 0;
+	PtrSize total_alloc_bytes = 0;
+};
+
+static Schedule BuildSchedule(IAllocator* allocator, SizeDistribution const& distribution, FreeOrder order, U64 seed)
+{
+	BenchmarkRandom random{seed};
+
+	S32 const allocation_count = distribution.allocation_count;
+	Schedule result{};
+	result.ops = PAW_NEW_SLICE_IN(allocator, allocation_count * 2, AllocatorOp);
+	result.slot_count = allocation_count;
+
+	S32 op_count = 0;
+	if (order == FreeOrder::Interleaved)
+	{
+		Slice<S32> const live_slots = PAW_NEW_SLICE_IN(allocator, allocation_count, S32);
+		S32 live_count = 0;
+		for (S32 i = 0; i < allocation_count; i++)
+		{
+			PtrSize const size_bytes = random.NextLogUniform(distribution.min_size_bytes, distribution.max_size_bytes);
+			result.ops[op_count++] = {i, size_bytes};
+			result.total_alloc_bytes += size_bytes + g_alignment;
+			live_slots[live_count++] = i;
+
+			if (random.Next() & 1)
+			{
+				S32 const live_index = static_cast<S32>(random.Next() % static_cast<U64>(live_count));
+				result.ops[op_count++] = {live_slots[live_index], 0};
+				live_slots[live_index] = live_slots[--live_count];
+			}
+		}
+
+		// Whatever is left is freed by the end of batch reset
+		result.ops = Slice<AllocatorOp>{result.ops.items, op_count};
+		return result;
+	}
+
+	for (S32 i = 0; i < allocation_count; i++)
+	{
+		PtrSize const size_bytes = random.NextLogUniform(distribution.min_size_bytes, distribution.max_size_bytes);
+		result.ops[op_count++] = {i, size_bytes};
+		result.total_alloc_bytes += size_bytes + g_alignment;
+	}
+
+	for (S32 i = 0; i < allocation_count; i++)
+	{
+		S32 const slot_index = order == FreeOrder::FIFO ? i : allocation_count - 1 - i;
+		result.ops[op_count++] = {slot_index, 0};
+	}
+
+	return result;
+}
+
+struct WorkerContext
+{
+	ArenaAllocator schedule_allocator{};
+	ArenaAllocator fixed_size_backing_allocator{};
+	FixedSizeArenaAllocator fixed_size_allocator{};
+	PagedArenaAllocator paged_allocator{};
+	ArenaAllocator arena_allocator{};
+	TLSFAllocator tlsf_allocator{};
+	SystemAllocator system_allocator{};
+
+	IAllocator* allocator = nullptr;
+	AllocatorKind kind = AllocatorKind::Count;
+
+	Schedule schedule{};
+	Slice<MemorySlice> slots{};
+	Slice<U64> samples_ns{};
+
+	PtrSize live_bytes = 0;
+	PtrSize peak_live_bytes = 0;
+};
+
+static IAllocator* SelectAllocator(WorkerContext& context, AllocatorKind kind)
+{
+	switch (kind)
+	{
+		case AllocatorKind::FixedSizeArena:
+		{
+			PtrSize const size_bytes = context.schedule.total_alloc_bytes;
+			MemorySlice const memory = context.fixed_size_backing_allocator.Alloc(size_bytes, g_alignment);
+			context.fixed_size_allocator.InitFromMemory(memory.ptr, memory.size_bytes);
+			return &context.fixed_size_allocator;
+		}
+		case AllocatorKind::PagedArena:
+			return &context.paged_allocator;
+		case AllocatorKind::Arena:
+			return &context.arena_allocator;
+		case AllocatorKind::TLSF:
+			return &context.tlsf_allocator;
+		case AllocatorKind::System:
+			return &context.system_allocator;
+		case AllocatorKind::Count:
+			break;
+	}
+	return nullptr;
+}
+
+static PtrSize GetCommittedBytes(WorkerContext const& context)
+{
+	if (context.kind == AllocatorKind::FixedSizeArena)
+	{
+		return context.fixed_size_backing_allocator.GetCommittedBytes();
+	}
+	return context.allocator->GetCommittedBytes();
+}
+
+// Returns the number of Alloc/Free calls made
+static S32 ResetAllocator(WorkerContext& context)
+{
+	S32 op_count = 0;
+	switch (context.kind)
+	{
+		case AllocatorKind::FixedSizeArena:
+			context.fixed_size_allocator.FreeAll();
+			break;
+		case AllocatorKind::PagedArena:
+			context.paged_allocator.FreeAll();
+			break;
+		case AllocatorKind::Arena:
+			context.arena_allocator.FreeAll();
+			break;
+		case AllocatorKind::TLSF:
+		case AllocatorKind::System:
+		case AllocatorKind::Count:
+			for (MemorySlice& slot : context.slots)
+			{
+				if (slot.ptr)
+				{
+					context.allocator->Free(slot);
+					op_count++;
+				}
+			}
+			break;
+	}
+
+	for (MemorySlice& slot : context.slots)
+	{
+		slot = {};
+	}
+	context.live_bytes = 0;
+	return op_count;
+}
+
+static void RunWorker(WorkerContext& context, S32 iteration_count, std::atomic<S32>& ready_count, S32 thread_count)
+{
+	ready_count.fetch_add(1, std::memory_order_relaxed);
+	while (ready_count.load(std::memory_order_relaxed) < thread_count)
+	{
+	}
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		bool const is_last_iteration = iteration == iteration_count - 1;
+
+		U64 const start_ns = benchmark_get_time_ns();
+		S32 op_count = 0;
+		for (AllocatorOp const& op : context.schedule.ops)
+		{
+			MemorySlice& slot = context.slots[op.slot_index];
+			if (op.size_bytes != 0)
+			{
+				slot = context.allocator->Alloc(op.size_bytes, g_alignment);
+				slot.ptr[0] = 1;
+				context.live_bytes += op.size_bytes;
+				context.peak_live_bytes = context.live_bytes > context.peak_live_bytes ? context.live_bytes : context.peak_live_bytes;
+			}
+			else
+			{
+				context.allocator->Free(slot);
+				context.live_bytes -= slot.size_bytes;
+				slot = {};
+			}
+			op_count++;
+		}
+
+		// Keep the last batch's memory around for the footprint numbers
+		if (!is_last_iteration)
+		{
+			op_count += ResetAllocator(context);
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+
+		context.samples_ns[iteration] = (end_ns - start_ns) / static_cast<U64>(op_count > 0 ? op_count : 1);
+	}
+}
+
+static void RunSeries(BenchmarkState& state, SizeDistribution const& distribution, AllocatorKind kind, FreeOrder order, S32 thread_count)
+{
+	S32 iteration_count = state.GetIterationCount() < distribution.max_iteration_count ? state.GetIterationCount() : distribution.max_iteration_count;
+	iteration_count = iteration_count * thread_count > BenchmarkState::max_sample_count ? BenchmarkState::max_sample_count / thread_count : iteration_count;
+
+	U64 const rss_before_bytes = benchmark_platform_read_rss_bytes();
+
+	// Heap allocated, TLSF's bin tables make a context too big to keep eight of them on the stack comfortably
+	WorkerContext* const contexts = new WorkerContext[g_max_thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		WorkerContext& context = contexts[thread_index];
+		context.kind = kind;
+		context.schedule = BuildSchedule(&context.schedule_allocator, distribution, order, 0x9E3779B97F4A7C15ull + static_cast<U64>(thread_index));
+		context.slots = PAW_NEW_SLICE_IN(&context.schedule_allocator, context.schedule.slot_count, MemorySlice);
+		context.samples_ns = PAW_NEW_SLICE_IN(&context.schedule_allocator, iteration_count, U64);
+		context.allocator = SelectAllocator(context, kind);
+	}
+
+	std::atomic<S32> ready_count = 0;
+	std::thread threads[g_max_thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index] = std::thread(RunWorker, std::ref(contexts[thread_index]), iteration_count, std::ref(ready_count), thread_count);
+	}
+
+	PtrSize committed_bytes = 0;
+	PtrSize peak_live_bytes = 0;
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index].join();
+
+		WorkerContext& context = contexts[thread_index];
+		for (U64 sample_ns : context.samples_ns)
+		{
+			state.AddSample(sample_ns);
+		}
+		committed_bytes += GetCommittedBytes(context);
+		peak_live_bytes += context.peak_live_bytes;
+	}
+
+	U64 const rss_after_bytes = benchmark_platform_read_rss_bytes();
+	U64 const rss_delta_bytes = rss_after_bytes > rss_before_bytes ? rss_after_bytes - rss_before_bytes : 0;
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s %s %s %dt (ns/op)", g_allocator_kind_names[static_cast<S32>(kind)], distribution.name, g_free_order_names[static_cast<S32>(order)], thread_count);
+	state.Report(label);
+
+	// malloc doesn't say what it has committed, RSS is the closest thing
+	PtrSize const footprint_bytes = kind == AllocatorKind::System ? rss_delta_bytes : committed_bytes;
+	double const fragmentation = footprint_bytes > 0 && footprint_bytes > peak_live_bytes ? 1.0 - static_cast<double>(peak_live_bytes) / static_cast<double>(footprint_bytes) : 0.0;
+	std::fprintf(
+		stdout,
+		"%-48s committed=%lluKiB rss=%lluKiB live=%lluKiB fragmentation=%.1f%%%s\n",
+		"",
+		static_cast<unsigned long long>(committed_bytes / 1024),
+		static_cast<unsigned long long>(rss_delta_bytes / 1024),
+		static_cast<unsigned long long>(peak_live_bytes / 1024),
+		fragmentation * 100.0,
+		kind == AllocatorKind::System ? " (vs rss)" : "");
+
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		WorkerContext& context = contexts[thread_index];
+		ResetAllocator(context);
+	}
+	delete[] contexts;
+}
+
+static void RunDistribution(BenchmarkState& state, SizeDistribution const& distribution)
+{
+	S32 const hardware_thread_count = static_cast<S32>(std::thread::hardware_concurrency());
+	for (S32 kind_index = 0; kind_index < static_cast<S32>(AllocatorKind::Count); kind_index++)
+	{
+		AllocatorKind const kind = static_cast<AllocatorKind>(kind_index);
+		for (S32 order_index = 0; order_index < static_cast<S32>(FreeOrder::Count); order_index++)
+		{
+			for (S32 thread_count : g_thread_counts)
+			{
+				if (thread_count > 1 && thread_count > hardware_thread_count)
+				{
+					continue;
+				}
+				RunSeries(state, distribution, kind, static_cast<FreeOrder>(order_index), thread_count);
+			}
+		}
+	}
+}
+
+PAW_BENCHMARK(UINodes)
+{
+	RunDistribution(state, {.name = "ui-nodes", .min_size_bytes = 16, .max_size_bytes = 256, .allocation_count = 1024, .max_iteration_count = 1000});
+}
+
+PAW_BENCHMARK(JobLinks)
+{
+	RunDistribution(state, {.name = "job-links", .min_size_bytes = 64, .max_size_bytes = 64, .allocation_count = 1024, .max_iteration_count = 1000});
+}
+
+PAW_BENCHMARK(LargeSlices)
+{
+	RunDistribution(state, {.name = "large-slices", .min_size_bytes = KiloBytes(64), .max_size_bytes = MegaBytes(4), .allocation_count = 32, .max_iteration_count = 20});
+}
+
+// Many UI-node sized blocks live at once, so TLSF's per-block header and alignment padding show up in the footprint.
+// Overhead is committed bytes minus requested bytes, spread over the allocations.
+PAW_BENCHMARK(TLSFSmallObjects)
+{
+	static constexpr S32 allocation_count = 16384;
+	S32 const iteration_count = state.GetIterationCount() < 100 ? state.GetIterationCount() : 100;
+	MemorySlice* const allocations = new MemorySlice[allocation_count];
+
+	PtrSize overhead_bytes = 0;
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		TLSFAllocator allocator{};
+		BenchmarkRandom random{0x9E3779B97F4A7C15ull + static_cast<U64>(iteration)};
+
+		PtrSize requested_bytes = 0;
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < allocation_count; i++)
+		{
+			PtrSize const size_bytes = random.NextLogUniform(16, 256);
+			allocations[i] = allocator.Alloc(size_bytes, g_alignment);
+			requested_bytes += size_bytes;
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		state.AddSample((end_ns - start_ns) / allocation_count);
+
+		overhead_bytes = allocator.GetCommittedBytes() - requested_bytes;
+		for (S32 i = 0; i < allocation_count; i++)
+		{
+			allocator.Free(allocations[i]);
+		}
+	}
+
+	state.Report("TLSF small-objects alloc (ns/op)");
+	std::fprintf(stdout, "%-48s overhead=%.1fB/alloc\n", "", static_cast<double>(overhead_bytes) / allocation_count);
+	delete[] allocations;
+}
+
+// Node sized allocations like widgets, job links and render graph refs. Build allocates a batch and tears it down the
+// way the allocator does best, FreeAll for the arena and the slab and one Free per node for TLSF. Churn keeps the batch
+// live and replaces random nodes, which the arena can only do by growing.
+static constexpr S32 g_node_count = 16384;
+static constexpr PtrSize g_node_size_bytes = 64;
+
+template <typename AllocatorType>
+static void RunNodeSeries(BenchmarkState& state, char const* name, AllocatorType& allocator)
+{
+	MemorySlice* const nodes = new MemorySlice[g_node_count];
+	S32 const iteration_count = state.GetIterationCount() < 200 ? state.GetIterationCount() : 200;
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_node_count; i++)
+		{
+			nodes[i] = allocator.Alloc(g_node_size_bytes, g_alignment);
+			nodes[i].ptr[0] = 1;
+		}
+		if constexpr (std::is_same_v<AllocatorType, TLSFAllocator>)
+		{
+			for (S32 i = 0; i < g_node_count; i++)
+			{
+				allocator.Free(nodes[i]);
+			}
+		}
+		else
+		{
+			allocator.FreeAll();
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		state.AddSample((end_ns - start_ns) / g_node_count);
+	}
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s nodes build (ns/node)", name);
+	state.Report(label);
+
+	for (S32 i = 0; i < g_node_count; i++)
+	{
+		nodes[i] = allocator.Alloc(g_node_size_bytes, g_alignment);
+	}
+
+	BenchmarkRandom random{0xBB67AE8584CAA73Bull};
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_node_count; i++)
+		{
+			MemorySlice& node = nodes[random.Next() % g_node_count];
+			allocator.Free(node);
+			node = allocator.Alloc(g_node_size_bytes, g_alignment);
+			node.ptr[0] = 1;
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		state.AddSample((end_ns - start_ns) / g_node_count);
+	}
+
+	std::snprintf(label, sizeof(label), "%s nodes churn (ns/replace)", name);
+	state.Report(label);
+	std::fprintf(stdout, "%-48s committed=%lluKiB live=%lluKiB\n", "", static_cast<unsigned long long>(allocator.GetCommittedBytes() / 1024), static_cast<unsigned long long>(g_node_count * g_node_size_bytes / 1024));
+
+	delete[] nodes;
+}
+
+PAW_BENCHMARK(FixedSizeNodes)
+{
+	{
+		SlabAllocator allocator{g_node_size_bytes, g_alignment};
+		RunNodeSeries(state, "Slab", allocator);
+	}
+	{
+		ArenaAllocator allocator{};
+		RunNodeSeries(state, "Arena", allocator);
+	}
+	{
+		TLSFAllocator allocator{};
+		RunNodeSeries(state, "TLSF", allocator);
+	}
+}
+
+// GetStats is meant to be sampled every frame, so it has to stay cheap on a big fragmented heap
+PAW_BENCHMARK(TLSFStats)
+{
+	static constexpr S32 allocation_count = 65536;
+	MemorySlice* const allocations = new MemorySlice[allocation_count];
+
+	TLSFAllocator allocator{};
+	BenchmarkRandom random{0x3C6EF372FE94F82Bull};
+	for (S32 i = 0; i < allocation_count; i++)
+	{
+		allocations[i] = allocator.Alloc(random.NextLogUniform(16, KiloBytes(16)), g_alignment);
+	}
+	for (S32 i = 0; i < allocation_count; i += 2)
+	{
+		allocator.Free(allocations[i]);
+	}
+
+	TLSFStats stats{};
+	S32 const iteration_count = state.GetIterationCount() < BenchmarkState::max_sample_count ? state.GetIterationCount() : BenchmarkState::max_sample_count;
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		stats = allocator.GetStats();
+		U64 const end_ns = benchmark_get_time_ns();
+		state.AddSample(end_ns - start_ns);
+	}
+
+	U64 const verify_start_ns = benchmark_get_time_ns();
+	bool const is_valid = allocator.VerifyHeap();
+	U64 const verify_end_ns = benchmark_get_time_ns();
+
+	state.Report("TLSF GetStats, 32k free blocks (ns)");
+	std::fprintf(
+		stdout,
+		"%-48s free=%lluKiB blocks=%d fragmentation=%.1f%% verify=%lluus%s\n",
+		"",
+		static_cast<unsigned long long>(stats.free_bytes / 1024),
+		stats.free_block_count,
+		stats.external_fragmentation * 100.0f,
+		static_cast<unsigned long long>((verify_end_ns - verify_start_ns) / 1000),
+		is_valid ? "" : " (heap corrupted)");
+
+	for (S32 i = 1; i < allocation_count; i += 2)
+	{
+		allocator.Free(allocations[i]);
+	}
+	delete[] allocations;
+}
+
+class LockedTLSFAllocator final : public IAllocator
+{
+public:
+	MemorySlice Alloc(PtrSize size_bytes, PtrSize alignment) override
+	{
+		std::lock_guard const lock(mutex);
+		return allocator.Alloc(size_bytes, alignment);
+	}
+
+	void Free(MemorySlice memory) override
+	{
+		std::lock_guard const lock(mutex);
+		allocator.Free(memory);
+	}
+
+private:
+	std::mutex mutex;
+	TLSFAllocator allocator;
+};
+
+// Every thread shares one allocator and allocates a batch of UI-node sized blocks, then frees every other one of its own
+// and the rest of its neighbour's from the previous round so half the frees cross threads. Reported as ns per call.
+static void RunSharedHeapSeries(BenchmarkState& state, char const* name, IAllocator& allocator, S32 thread_count)
+{
+	static constexpr S32 batch_count = 512;
+	static constexpr S32 max_thread_count = 16;
+	S32 iteration_count = state.GetIterationCount() < 200 ? state.GetIterationCount() : 200;
+	iteration_count = iteration_count * thread_count > BenchmarkState::max_sample_count ? BenchmarkState::max_sample_count / thread_count : iteration_count;
+
+	MemorySlice* const batches = new MemorySlice[max_thread_count * batch_count]{};
+	U64* const samples_ns = new U64[max_thread_count * iteration_count];
+	std::atomic<S32> arrived_count = 0;
+
+	// Spins until every thread has reached the same round, generation counts the rounds
+	auto const wait_for_all = [&](S32 generation) {
+		arrived_count.fetch_add(1, std::memory_order_acq_rel);
+		while (arrived_count.load(std::memory_order_acquire) < thread_count * generation)
+		{
+			std::this_thread::yield();
+		}
+	};
+
+	std::thread threads[max_thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index] = std::thread([&, thread_index]() {
+			MemorySlice* const own = batches + thread_index * batch_count;
+			MemorySlice* const neighbour = batches + ((thread_index + 1) % thread_count) * batch_count;
+			BenchmarkRandom random{0x9E3779B97F4A7C15ull + static_cast<U64>(thread_index)};
+			S32 generation = 0;
+
+			for (S32 iteration = 0; iteration < iteration_count; iteration++)
+			{
+				U64 const alloc_start_ns = benchmark_get_time_ns();
+				for (S32 i = 0; i < batch_count; i++)
+				{
+					own[i] = allocator.Alloc(random.NextLogUniform(16, 256), g_alignment);
+				}
+				U64 const alloc_end_ns = benchmark_get_time_ns();
+
+				wait_for_all(++generation);
+
+				U64 const free_start_ns = benchmark_get_time_ns();
+				for (S32 i = 0; i < batch_count; i += 2)
+				{
+					allocator.Free(own[i]);
+					allocator.Free(neighbour[i + 1]);
+				}
+				U64 const free_end_ns = benchmark_get_time_ns();
+
+				wait_for_all(++generation);
+
+				U64 const elapsed_ns = (alloc_end_ns - alloc_start_ns) + (free_end_ns - free_start_ns);
+				samples_ns[thread_index * iteration_count + iteration] = elapsed_ns / (batch_count * 2);
+			}
+		});
+	}
+
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index].join();
+	}
+
+	for (S32 i = 0; i < thread_count * iteration_count; i++)
+	{
+		state.AddSample(samples_ns[i]);
+	}
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s %dt (ns/op)", name, thread_count);
+	state.Report(label);
+
+	delete[] samples_ns;
+	delete[] batches;
+}
+
+PAW_BENCHMARK(SharedHeapScaling)
+{
+	S32 const hardware_thread_count = static_cast<S32>(std::thread::hardware_concurrency());
+	for (S32 thread_count : {1, 2, 4, 8, 16})
+	{
+		if (thread_count > 1 && thread_count > hardware_thread_count)
+		{
+			continue;
+		}
+
+		{
+			LockedTLSFAllocator allocator{};
+			RunSharedHeapSeries(state, "TLSF+mutex", allocator, thread_count);
+		}
+		{
+			ThreadCachingTLSFAllocator allocator{};
+			RunSharedHeapSeries(state, "ThreadCachingTLSF", allocator, thread_count);
+		}
+		{
+			SystemAllocator allocator{};
+			RunSharedHeapSeries(state, "malloc", allocator, thread_count);
+		}
+	}
+}
@@ -0,0 +1,225 @@
+#include "benchmark.h"
+
+#include <core/assert.h>
+#include <core/memory.h>
+#include <core/string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static BenchmarkCase const* g_context = nullptr;
+
+void AssertFunc(char const* file, U32 line, char const* expression, char const* message)
+{
+	std::fprintf(stderr, "Assert in %s:%s:%s\nFile: %s\nLine: %d\nExpression: %s\nMessage: %s\n", g_context ? g_context->project : "", g_context ? g_context->module : "", g_context ? g_context->name : "", file, line, expression, message);
+}
+
+CoreAssertFunc* g_core_assert_func = &AssertFunc;
+
+class BenchmarkLocator : NonCopyable
+{
+public:
+	static BenchmarkLocator& get_instance()
+	{
+		static BenchmarkLocator instance{};
+		return instance;
+	}
+
+	void register_benchmark(BenchmarkCase* benchmark)
+	{
+		if (first_benchmark == nullptr)
+		{
+			first_benchmark = benchmark;
+			current_benchmark = benchmark;
+		}
+		else
+		{
+			current_benchmark->next_benchmark = benchmark;
+			current_benchmark = benchmark;
+		}
+	}
+
+	BenchmarkCase const* get_first_benchmark() const
+	{
+		return first_benchmark;
+	}
+
+private:
+	BenchmarkCase* first_benchmark = nullptr;
+	BenchmarkCase* current_benchmark = nullptr;
+};
+
+U64 benchmark_get_time_ns()
+{
+	auto const now = std::chrono::steady_clock::now().time_since_epoch();
+	return static_cast<U64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+BenchmarkState::BenchmarkState(S32 iteration_count)
+	: iteration_count(iteration_count)
+{
+}
+
+S32 BenchmarkState::GetIterationCount() const
+{
+	return iteration_count;
+}
+
+void BenchmarkState::BeginSample()
+{
+	sample_start_ns = benchmark_get_time_ns();
+}
+
+void BenchmarkState::EndSample()
+{
+	U64 const end_ns = benchmark_get_time_ns();
+	AddSample(end_ns - sample_start_ns);
+}
+
+void BenchmarkState::AddSample(U64 sample_ns)
+{
+	if (sample_count < max_sample_count)
+	{
+		samples_ns[sample_count++] = sample_ns;
+	}
+}
+
+void BenchmarkState::BeginCounters()
+{
+	counters_start = benchmark_platform_read_counters();
+}
+
+void BenchmarkState::EndCounters()
+{
+	BenchmarkCounters const end = benchmark_platform_read_counters();
+	counters_total.page_faults += end.page_faults - counters_start.page_faults;
+	counters_total.dtlb_misses += end.dtlb_misses - counters_start.dtlb_misses;
+	counters_total.has_dtlb_misses = end.has_dtlb_misses;
+	has_counters = true;
+}
+
+bool BenchmarkState::HasPendingSamples() const
+{
+	return sample_count > 0;
+}
+
+static U64 get_percentile(U64 const* sorted_samples, S32 count, S32 percentile)
+{
+	S32 const index = (count - 1) * percentile / 100;
+	return sorted_samples[index];
+}
+
+void BenchmarkState::Report(char const* label)
+{
+	if (sample_count == 0)
+	{
+		return;
+	}
+
+	std::sort(samples_ns, samples_ns + sample_count);
+
+	U64 total_ns = 0;
+	for (S32 i = 0; i < sample_count; i++)
+	{
+		total_ns += samples_ns[i];
+	}
+
+	std::fprintf(
+		stdout,
+		"%-48s n=%-6d mean=%-10llu min=%-10llu p50=%-10llu p90=%-10llu p99=%-10llu max=%-10llu (ns)\n",
+		label,
+		sample_count,
+		total_ns / static_cast<U64>(sample_count),
+		samples_ns[0],
+		get_percentile(samples_ns, sample_count, 50),
+		get_percentile(samples_ns, sample_count, 90),
+		get_percentile(samples_ns, sample_count, 99),
+		samples_ns[sample_count - 1]);
+
+	if (has_counters)
+	{
+		if (counters_total.has_dtlb_misses)
+		{
+			std::fprintf(stdout, "%-48s page_faults=%llu dtlb_misses=%llu\n", "", counters_total.page_faults, counters_total.dtlb_misses);
+		}
+		else
+		{
+			std::fprintf(stdout, "%-48s page_faults=%llu dtlb_misses=n/a\n", "", counters_total.page_faults);
+		}
+	}
+
+	sample_count = 0;
+	counters_total = {};
+	has_counters = false;
+}
+
+int benchmark_main(int arg_count, char* args[])
+{
+	MemoryInit();
+
+	S32 iteration_count = 1000;
+	char const* filter = nullptr;
+	bool list_only = false;
+
+	for (S32 i = 1; i < arg_count; i++)
+	{
+		if (strcmp("-list", args[i]) == 0)
+		{
+			list_only = true;
+		}
+		else if (strcmp("-iterations", args[i]) == 0 && i + 1 < arg_count)
+		{
+			iteration_count = static_cast<S32>(std::atoi(args[++i]));
+		}
+		else if (strcmp("-filter", args[i]) == 0 && i + 1 < arg_count)
+		{
+			filter = args[++i];
+		}
+	}
+
+	for (BenchmarkCase const* benchmark = BenchmarkLocator::get_instance().get_first_benchmark(); benchmark != nullptr; benchmark = benchmark->next_benchmark)
+	{
+		if (filter && std::strstr(benchmark->name, filter) == nullptr && std::strstr(benchmark->module, filter) == nullptr)
+		{
+			continue;
+		}
+
+		if (list_only)
+		{
+			fprintf(stdout, "%s::%s::%s - %s::%d\n", benchmark->project, benchmark->module, benchmark->name, benchmark->file, benchmark->line);
+			continue;
+		}
+
+		fprintf(stdout, "== %s::%s\n", benchmark->module, benchmark->name);
+
+		// Too big for the stack with max_sample_count samples
+		BenchmarkState* state = new BenchmarkState(iteration_count);
+		g_context = benchmark;
+		benchmark->function(*state);
+		g_context = nullptr;
+		if (state->HasPendingSamples())
+		{
+			state->Report(benchmark->name);
+		}
+		delete state;
+	}
+
+	MemoryDeinit();
+
+	return 0;
+}
+
+BenchmarkCase::BenchmarkCase(char const* project, char const* file, char const* module, char const* name, BenchmarkFunc* function, int line)
+	: project(project)
+	, file(file)
+	, module(module)
+	, name(name)
+	, function(function)
+	, line(line)
+	, next_benchmark(nullptr)
+{
+	BenchmarkLocator::get_instance().register_benchmark(this);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <core/std.h>
+
+#include "benchmark_platform.h"
+
+class BenchmarkState;
+
+typedef void BenchmarkFunc(BenchmarkState& state);
+
+class BenchmarkCase : NonCopyable
+{
+public:
+	BenchmarkCase(char const* project, char const* file, char const* module, char const* name, BenchmarkFunc* function, int line);
+
+	// private:
+	char const* const project;
+	char const* const file;
+	char const* const module;
+	char const* const name;
+	BenchmarkFunc* const function;
+	int const line;
+	BenchmarkCase* next_benchmark;
+};
+
+// Collects per-iteration timings. A benchmark can Report() several series (e.g. one per size) from a single function,
+// anything still pending when the function returns is reported under the benchmark's own name.
+class BenchmarkState : NonCopyable
+{
+public:
+	static constexpr S32 max_sample_count = 1 << 16;
+
+	BenchmarkState(S32 iteration_count);
+
+	S32 GetIterationCount() const;
+
+	void BeginSample();
+	void EndSample();
+	// For samples timed elsewhere, e.g. on worker threads. Not thread safe, merge them in from the calling thread.
+	void AddSample(U64 sample_ns);
+
+	// Accumulates page faults and dTLB misses between the calls, printed with the next Report()
+	void BeginCounters();
+	void EndCounters();
+
+	void Report(char const* label);
+	bool HasPendingSamples() const;
+
+private:
+	U64 samples_ns[max_sample_count];
+	S32 sample_count = 0;
+	S32 const iteration_count;
+	U64 sample_start_ns = 0;
+	BenchmarkCounters counters_start{};
+	BenchmarkCounters counters_total{};
+	bool has_counters = false;
+};
+
+#define PAW_BENCHMARK_CONCAT_EX(x, y) x##y
+#define PAW_BENCHMARK_CONCAT(x, y) PAW_BENCHMARK_CONCAT_EX(x, y)
+
+#define PAW_BENCHMARK_FUNC_NAME(name) PAW_BENCHMARK_CONCAT(PAW_BENCHMARK_CONCAT(name, _benchmark_func), __LINE__)
+
+#define PAW_BENCHMARK_STRINGIFY_EX(x) #x
+#define PAW_BENCHMARK_STRINGIFY(x) PAW_BENCHMARK_STRINGIFY_EX(x)
+
+#define PAW_BENCHMARK_VAR_NAME(name) PAW_BENCHMARK_CONCAT(g_, PAW_BENCHMARK_CONCAT(PAW_BENCHMARK_CONCAT(PAW_BENCHMARK_MODULE_NAME, name), __LINE__))
+
+#define PAW_BENCHMARK(name)                                   \
+	static void PAW_BENCHMARK_FUNC_NAME(name)(BenchmarkState&); \
+	static BenchmarkCase PAW_BENCHMARK_VAR_NAME(name){          \
+		PAW_BENCHMARK_STRINGIFY(PAW_TEST_PROJECT_NAME),         \
+		__FILE__,                                               \
+		PAW_BENCHMARK_STRINGIFY(PAW_BENCHMARK_MODULE_NAME),     \
+		#name,                                                  \
+		&PAW_BENCHMARK_FUNC_NAME(name),                         \
+		__LINE__,                                               \
+	};                                                          \
+	static void PAW_BENCHMARK_FUNC_NAME(name)(BenchmarkState & state)
+
+// Stops the optimizer from throwing away work whose result is otherwise unused
+template <typename T>
+inline void BenchmarkDoNotOptimize(T const& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+U64 benchmark_get_time_ns();
+
+int benchmark_main(int arg_count, char* args[]);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <core/std.h>
+
+struct BenchmarkCounters
+{
+	U64 page_faults = 0;
+	U64 dtlb_misses = 0;
+	bool has_dtlb_misses = false;
+};
+
+// Cumulative counters for the calling thread (page faults are process wide on Windows)
+BenchmarkCounters benchmark_platform_read_counters();
+
+// Resident set size of the whole process
+U64 benchmark_platform_read_rss_bytes();
@@ -0,0 +1,81 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "benchmark_platform.h"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
+static int OpenDtlbMissCounter()
+{
+	perf_event_attr attr{};
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	// Fails without CAP_PERFMON or with a strict perf_event_paranoid, in which case dTLB misses are reported as n/a
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+BenchmarkCounters benchmark_platform_read_counters()
+{
+	BenchmarkCounters result{};
+
+	rusage usage{};
+#if defined(RUSAGE_THREAD)
+	getrusage(RUSAGE_THREAD, &usage);
+#else
+	getrusage(RUSAGE_SELF, &usage);
+#endif
+	result.page_faults = static_cast<U64>(usage.ru_minflt + usage.ru_majflt);
+
+#if defined(__linux__)
+	static int const dtlb_fd = OpenDtlbMissCounter();
+	U64 dtlb_misses = 0;
+	if (dtlb_fd >= 0 && read(dtlb_fd, &dtlb_misses, sizeof(dtlb_misses)) == sizeof(dtlb_misses))
+	{
+		result.dtlb_misses = dtlb_misses;
+		result.has_dtlb_misses = true;
+	}
+#endif
+
+	return result;
+}
+
+U64 benchmark_platform_read_rss_bytes()
+{
+#if defined(__linux__)
+	// Second field of statm is the resident page count
+	FILE* const file = std::fopen("/proc/self/statm", "r");
+	if (file == nullptr)
+	{
+		return 0;
+	}
+
+	unsigned long long total_pages = 0;
+	unsigned long long resident_pages = 0;
+	int const read_count = std::fscanf(file, "%llu %llu", &total_pages, &resident_pages);
+	std::fclose(file);
+	if (read_count != 2)
+	{
+		return 0;
+	}
+
+	return static_cast<U64>(resident_pages) * static_cast<U64>(sysconf(_SC_PAGESIZE));
+#else
+	// Only the peak is available without mach calls
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<U64>(usage.ru_maxrss);
+#endif
+}
+
+#endif
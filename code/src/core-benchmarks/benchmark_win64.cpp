@@ -0,0 +1,32 @@
+#include "benchmark_platform.h"
+
+#include <Windows.h>
+#include <psapi.h>
+
+BenchmarkCounters benchmark_platform_read_counters()
+{
+	BenchmarkCounters result{};
+
+	PROCESS_MEMORY_COUNTERS counters{};
+	counters.cb = sizeof(counters);
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		result.page_faults = counters.PageFaultCount;
+	}
+
+	// There's no user mode access to the TLB counters without ETW/VTune
+	result.has_dtlb_misses = false;
+
+	return result;
+}
+
+U64 benchmark_platform_read_rss_bytes()
+{
+	PROCESS_MEMORY_COUNTERS counters{};
+	counters.cb = sizeof(counters);
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize;
+	}
+	return 0;
+}
@@ -0,0 +1,295 @@
+#include "benchmark.h"
+
+#include <core/handle_pool.h>
+#include <core/hash_map.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/tlsf.h>
+#include <core/varray.h>
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#define PAW_BENCHMARK_MODULE_NAME Containers
+
+struct ContainerRandom
+{
+	U64 state;
+
+	U64 Next()
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		return state >> 16;
+	}
+};
+
+// Roughly an ECS component or a gfx object record
+struct PoolItem
+{
+	F32 position[3];
+	F32 velocity[3];
+	U32 flags;
+	U32 owner;
+};
+
+static constexpr S32 g_pool_item_count = 65536;
+
+// Handle lookups, churn and a walk over every live item. The same walk through individually allocated items in random
+// order is what pointer based storage costs.
+PAW_BENCHMARK(HandlePool)
+{
+	TLSFAllocator allocator{};
+	HandlePool<PoolItem> pool{&allocator};
+	Handle<PoolItem>* const handles = new Handle<PoolItem>[g_pool_item_count];
+	PoolItem** const pointers = new PoolItem*[g_pool_item_count];
+	for (S32 i = 0; i < g_pool_item_count; i++)
+	{
+		handles[i] = pool.Alloc(PoolItem{.flags = static_cast<U32>(i)});
+		pointers[i] = PAW_NEW_IN(&allocator, PoolItem)(PoolItem{.flags = static_cast<U32>(i)});
+	}
+
+	ContainerRandom random{0x510E527FADE682D1ull};
+	for (S32 i = g_pool_item_count - 1; i > 0; i--)
+	{
+		S32 const j = static_cast<S32>(random.Next() % static_cast<U64>(i + 1));
+		PoolItem* const swap = pointers[i];
+		pointers[i] = pointers[j];
+		pointers[j] = swap;
+	}
+
+	S32 const iteration_count = state.GetIterationCount() < 200 ? state.GetIterationCount() : 200;
+	U64 checksum = 0;
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_pool_item_count; i++)
+		{
+			checksum += pool.GetValue(handles[random.Next() % g_pool_item_count]).flags;
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) / g_pool_item_count);
+	}
+	state.Report("HandlePool random lookup (ns/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_pool_item_count; i++)
+		{
+			Handle<PoolItem>& handle = handles[random.Next() % g_pool_item_count];
+			U32 const flags = pool.GetValue(handle).flags;
+			pool.Free(handle);
+			handle = pool.Alloc(PoolItem{.flags = flags});
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) / g_pool_item_count);
+	}
+	state.Report("HandlePool free + alloc (ns/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (PoolItem& item : pool)
+		{
+			item.position[0] += item.velocity[0];
+			checksum += item.flags;
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_pool_item_count);
+	}
+	state.Report("HandlePool dense iteration (ps/item)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_pool_item_count; i++)
+		{
+			PoolItem& item = *pointers[i];
+			item.position[0] += item.velocity[0];
+			checksum += item.flags;
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_pool_item_count);
+	}
+	state.Report("Pointer array iteration (ps/item)");
+	std::fprintf(stdout, "%-48s checksum=%llu\n", "", static_cast<unsigned long long>(checksum));
+
+	for (S32 i = 0; i < g_pool_item_count; i++)
+	{
+		PAW_DELETE_IN(&allocator, pointers[i]);
+	}
+	delete[] pointers;
+	delete[] handles;
+}
+
+static constexpr S32 g_push_item_count = 1 << 20;
+
+// Filling an array from empty, which is what a per frame list with no good upper bound does. std::vector doubles and
+// copies everything on each growth, VArray only commits the next pages. Release hands the pages back so every iteration
+// pays for its commits again, the same as a vector that's thrown away.
+PAW_BENCHMARK(VArrayPushBack)
+{
+	S32 const iteration_count = state.GetIterationCount() < 50 ? state.GetIterationCount() : 50;
+	U64 checksum = 0;
+
+	TLSFAllocator allocator{};
+	VArray<PoolItem> array{&allocator};
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_push_item_count; i++)
+		{
+			array.PushBack(PoolItem{.flags = static_cast<U32>(i)});
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		checksum += array[g_push_item_count / 2].flags;
+		array.Release();
+		state.AddSample((end_ns - start_ns) * 1000 / g_push_item_count);
+	}
+	state.Report("VArray push_back (ps/item)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		std::vector<PoolItem> vector;
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_push_item_count; i++)
+		{
+			vector.push_back(PoolItem{.flags = static_cast<U32>(i)});
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		checksum += vector[g_push_item_count / 2].flags;
+		state.AddSample((end_ns - start_ns) * 1000 / g_push_item_count);
+	}
+	state.Report("std::vector doubling push_back (ps/item)");
+
+	// Lower bound, the size is known up front
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		std::vector<PoolItem> vector;
+		vector.reserve(g_push_item_count);
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_push_item_count; i++)
+		{
+			vector.push_back(PoolItem{.flags = static_cast<U32>(i)});
+		}
+		U64 const end_ns = benchmark_get_time_ns();
+		checksum += vector[g_push_item_count / 2].flags;
+		state.AddSample((end_ns - start_ns) * 1000 / g_push_item_count);
+	}
+	state.Report("std::vector reserved push_back (ps/item)");
+	std::fprintf(stdout, "%-48s checksum=%llu\n", "", static_cast<unsigned long long>(checksum));
+}
+
+static constexpr S32 g_map_key_count = 1 << 18;
+
+// Random 64-bit keys, so the table is far bigger than L2 and every lookup is roughly one cache miss on the control bytes
+// and one on the slot. Misses use keys that were never added. std::unordered_map is the node based baseline.
+PAW_BENCHMARK(HashMap)
+{
+	U64* const keys = new U64[g_map_key_count];
+	U64* const missing_keys = new U64[g_map_key_count];
+	ContainerRandom random{0x9B05688C2B3E6C1Full};
+	for (S32 i = 0; i < g_map_key_count; i++)
+	{
+		keys[i] = random.Next() | 1;
+		missing_keys[i] = random.Next() & ~1ull;
+	}
+
+	S32 const iteration_count = state.GetIterationCount() < 50 ? state.GetIterationCount() : 50;
+	U64 checksum = 0;
+
+	TLSFAllocator allocator{};
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		HashMap<U64, U64> map{&allocator};
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			map.Set(keys[i], static_cast<U64>(i));
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+		checksum += map.GetCount();
+	}
+	state.Report("HashMap insert, growing (ps/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		std::unordered_map<U64, U64> map;
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			map[keys[i]] = static_cast<U64>(i);
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+		checksum += map.size();
+	}
+	state.Report("std::unordered_map insert, growing (ps/op)");
+
+	HashMap<U64, U64> map{&allocator};
+	std::unordered_map<U64, U64> std_map;
+	for (S32 i = 0; i < g_map_key_count; i++)
+	{
+		map.Set(keys[i], static_cast<U64>(i));
+		std_map[keys[i]] = static_cast<U64>(i);
+	}
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			checksum += *map.Find(keys[(i * 7919) & (g_map_key_count - 1)]);
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+	}
+	state.Report("HashMap lookup hit (ps/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			checksum += std_map.find(keys[(i * 7919) & (g_map_key_count - 1)])->second;
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+	}
+	state.Report("std::unordered_map lookup hit (ps/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			checksum += map.Contains(missing_keys[i]) ? 1 : 0;
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+	}
+	state.Report("HashMap lookup miss (ps/op)");
+
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			checksum += std_map.count(missing_keys[i]);
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+	}
+	state.Report("std::unordered_map lookup miss (ps/op)");
+
+	// Remove and re-add so the table sees constant churn, without tombstones the lookups after it cost the same
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (S32 i = 0; i < g_map_key_count; i++)
+		{
+			U64 const key = keys[(i * 7919) & (g_map_key_count - 1)];
+			map.Remove(key);
+			map.Set(key, static_cast<U64>(i));
+		}
+		state.AddSample((benchmark_get_time_ns() - start_ns) * 1000 / g_map_key_count);
+	}
+	state.Report("HashMap remove + insert (ps/op)");
+	std::fprintf(stdout, "%-48s checksum=%llu\n", "", static_cast<unsigned long long>(checksum));
+
+	delete[] missing_keys;
+	delete[] keys;
+}
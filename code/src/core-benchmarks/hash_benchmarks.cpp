@@ -0,0 +1,93 @@
+#include "benchmark.h"
+
+#include <core/hash.h>
+#include <core/memory.h>
+
+#include <cstdio>
+#include <cstring>
+
+#define PAW_BENCHMARK_MODULE_NAME Hash
+
+// Throughput per input size. Each sample hashes the same buffer enough times to cover about 16 MiB, which stays in cache
+// for the small sizes and streams from memory for the largest. FNV-1a, the usual byte at a time hash, is the baseline.
+// Samples are ns for the whole batch, GB/s is worked out from the mean.
+
+static U64 HashFnv1a(Byte const* data, PtrSize size_bytes)
+{
+	U64 hash = 0xCBF29CE484222325ull;
+	for (PtrSize i = 0; i < size_bytes; i++)
+	{
+		hash = (hash ^ data[i]) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+template <typename HashFunc>
+static void RunHashSeries(BenchmarkState& state, char const* name, Byte const* data, PtrSize size_bytes, HashFunc&& hash_func)
+{
+	static constexpr PtrSize bytes_per_sample = MegaBytes(16);
+	PtrSize const repeat_count = bytes_per_sample / size_bytes > 0 ? bytes_per_sample / size_bytes : 1;
+	S32 const iteration_count = state.GetIterationCount() < 20 ? state.GetIterationCount() : 20;
+
+	U64 total_ns = 0;
+	U64 checksum = 0;
+	for (S32 iteration = 0; iteration < iteration_count; iteration++)
+	{
+		U64 const start_ns = benchmark_get_time_ns();
+		for (PtrSize repeat = 0; repeat < repeat_count; repeat++)
+		{
+			checksum += hash_func(data, size_bytes);
+			// The memory clobber stops the compiler from assuming the data is unchanged and hoisting the call out of the loop
+			BenchmarkDoNotOptimize(checksum);
+		}
+		U64 const sample_ns = benchmark_get_time_ns() - start_ns;
+		state.AddSample(sample_ns);
+		total_ns += sample_ns;
+	}
+
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s %zu B", name, size_bytes);
+	state.Report(label);
+
+	F64 const total_bytes = static_cast<F64>(size_bytes) * static_cast<F64>(repeat_count) * iteration_count;
+	std::fprintf(stdout, "%-48s %.2f GB/s\n", "", total_bytes / static_cast<F64>(total_ns));
+}
+
+PAW_BENCHMARK(Throughput)
+{
+	static constexpr PtrSize sizes[] = {8, 16, 64, 256, 1024, KiloBytes(16), MegaBytes(1), MegaBytes(64)};
+	static constexpr PtrSize max_size_bytes = MegaBytes(64);
+
+	Byte* const data = new Byte[max_size_bytes];
+	U64 random = 0x8F1BBCDC6ED9EBA1ull;
+	for (PtrSize i = 0; i < max_size_bytes; i += sizeof(U64))
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		std::memcpy(data + i, &random, sizeof(U64));
+	}
+
+	for (PtrSize size_bytes : sizes)
+	{
+		RunHashSeries(state, "Hash64", data, size_bytes, [](Byte const* bytes, PtrSize size) { return Hash64(bytes, size); });
+	}
+
+	for (PtrSize size_bytes : sizes)
+	{
+		if (size_bytes <= MegaBytes(1))
+		{
+			RunHashSeries(state, "FNV-1a", data, size_bytes, &HashFnv1a);
+		}
+	}
+
+	// The same bytes fed through the streaming interface in 4 KiB pieces, e.g. a file read in chunks
+	RunHashSeries(state, "Hash64Stream 4 KiB pieces,", data, MegaBytes(1), [](Byte const* bytes, PtrSize size) {
+		Hash64Stream stream{};
+		for (PtrSize offset = 0; offset < size; offset += KiloBytes(4))
+		{
+			stream.Update(bytes + offset, KiloBytes(4));
+		}
+		return stream.Finish();
+	});
+
+	delete[] data;
+}
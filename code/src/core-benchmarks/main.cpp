@@ -0,0 +1,7 @@
+#include "benchmark.h"
+
+int main(int arg_count, char* args[])
+{
+	int result = benchmark_main(arg_count, args);
+	return result;
+}
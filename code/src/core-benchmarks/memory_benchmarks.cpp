@@ -0,0 +1,273 @@
+#include "benchmark.h"
+
+#include <core/arena.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/platform.h>
+
+#include <cstdio>
+
+#define PAW_BENCHMARK_MODULE_NAME Memory
+
+static constexpr PtrSize g_commit_sizes_bytes[]{
+	KiloBytes(64),
+	MegaBytes(2),
+	MegaBytes(32),
+};
+
+static Byte* GetBenchmarkAddressSpace()
+{
+	// Kept separate from the allocator address space so nothing else touches these pages while we measure
+	static Byte* const address_space = PlatformReserveAddressSpace(GigaBytes(1));
+	return address_space;
+}
+
+static void TouchPages(Byte* ptr, PtrSize size_bytes)
+{
+	for (PtrSize offset = 0; offset < size_bytes; offset += KiloBytes(4))
+	{
+		ptr[offset] = 1;
+	}
+}
+
+PAW_BENCHMARK(CommitLatency)
+{
+	Byte* const address_space = GetBenchmarkAddressSpace();
+	for (PtrSize size_bytes : g_commit_sizes_bytes)
+	{
+		for (S32 i = 0; i < state.GetIterationCount(); i++)
+		{
+			state.BeginSample();
+			PlatformCommitAddressSpace(address_space, size_bytes);
+			state.EndSample();
+			PlatformDecommitAddressSpace(address_space, size_bytes);
+		}
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "commit %llu KiB", size_bytes / KiloBytes(1));
+		state.Report(label);
+	}
+}
+
+PAW_BENCHMARK(DecommitLatency)
+{
+	Byte* const address_space = GetBenchmarkAddressSpace();
+	for (PtrSize size_bytes : g_commit_sizes_bytes)
+	{
+		for (S32 i = 0; i < state.GetIterationCount(); i++)
+		{
+			PlatformCommitAddressSpace(address_space, size_bytes);
+			// Decommitting untouched pages is close to free, so back them first to measure the real release cost
+			TouchPages(address_space, size_bytes);
+			state.BeginSample();
+			PlatformDecommitAddressSpace(address_space, size_bytes);
+			state.EndSample();
+		}
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "decommit touched %llu KiB", size_bytes / KiloBytes(1));
+		state.Report(label);
+	}
+}
+
+PAW_BENCHMARK(CommitAndFirstTouch)
+{
+	Byte* const address_space = GetBenchmarkAddressSpace();
+	for (PtrSize size_bytes : g_commit_sizes_bytes)
+	{
+		for (S32 i = 0; i < state.GetIterationCount(); i++)
+		{
+			state.BeginSample();
+			PlatformCommitAddressSpace(address_space, size_bytes);
+			TouchPages(address_space, size_bytes);
+			state.EndSample();
+			PlatformDecommitAddressSpace(address_space, size_bytes);
+		}
+
+		char label[64];
+		std::snprintf(label, sizeof(label), "commit + touch %llu KiB", size_bytes / KiloBytes(1));
+		state.Report(label);
+	}
+}
+
+PAW_BENCHMARK(AllocatorPageCycle)
+{
+	// What an arena pays per frame today: register, grow page by page, then release everything on reset
+	class PageCycleAllocator final : public IAllocator
+	{
+	public:
+		MemorySlice Alloc(PtrSize, PtrSize) override
+		{
+			return {};
+		}
+
+		void Free(MemorySlice) override
+		{
+		}
+
+		void Cycle(PtrSize page_count)
+		{
+			for (PtrSize i = 0; i < page_count; i++)
+			{
+				AllocPages(1);
+			}
+			FreeAllPages();
+		}
+	};
+
+	PageCycleAllocator allocator{};
+	for (S32 i = 0; i < state.GetIterationCount(); i++)
+	{
+		state.BeginSample();
+		allocator.Cycle(16);
+		state.EndSample();
+	}
+	state.Report("16 x AllocPages(1) + FreeAllPages");
+}
+
+static void RunLargeArenaWorkload(BenchmarkState& state, PageConfig page_config, char const* label)
+{
+	static constexpr PtrSize total_size_bytes = MegaBytes(256);
+	static constexpr PtrSize allocation_size_bytes = MegaBytes(1);
+	static constexpr S32 random_access_count = 1 << 22;
+
+	S32 const iteration_count = state.GetIterationCount() < 4 ? state.GetIterationCount() : 4;
+	for (S32 i = 0; i < iteration_count; i++)
+	{
+		ArenaAllocator allocator{page_config};
+
+		state.BeginCounters();
+		state.BeginSample();
+
+		Byte* first = nullptr;
+		for (PtrSize offset = 0; offset < total_size_bytes; offset += allocation_size_bytes)
+		{
+			MemorySlice const memory = allocator.Alloc(allocation_size_bytes, 16);
+			first = first ? first : memory.ptr;
+			TouchPages(memory.ptr, memory.size_bytes);
+		}
+
+		// Scattered reads are where the page size shows up in TLB reach
+		U64 random = 0x9E3779B97F4A7C15ull;
+		U64 sum = 0;
+		for (S32 access_index = 0; access_index < random_access_count; access_index++)
+		{
+			random = random * 6364136223846793005ull + 1442695040888963407ull;
+			sum += first[(random >> 16) % total_size_bytes];
+		}
+		BenchmarkDoNotOptimize(sum);
+
+		state.EndSample();
+		state.EndCounters();
+	}
+
+	state.Report(label);
+}
+
+PAW_BENCHMARK(PageSize)
+{
+	RunLargeArenaWorkload(state, {.mode = PageMode::Small}, "256 MiB arena, 64 KiB pages");
+	RunLargeArenaWorkload(state, {.mode = PageMode::Small, .prefault = true}, "256 MiB arena, 64 KiB pages, prefault");
+	RunLargeArenaWorkload(state, {.mode = PageMode::Huge}, "256 MiB arena, 2 MiB transparent huge pages");
+	RunLargeArenaWorkload(state, {.mode = PageMode::ExplicitHuge}, "256 MiB arena, 2 MiB explicit huge pages");
+}
+
+static void RunFrameResetWorkload(BenchmarkState& state, RetentionPolicy policy, char const* label)
+{
+	static constexpr PtrSize frame_size_bytes = MegaBytes(4);
+	static constexpr PtrSize allocation_size_bytes = KiloBytes(4);
+
+	ArenaAllocator allocator{};
+	allocator.SetRetentionPolicy(policy);
+
+	S32 const iteration_count = state.GetIterationCount();
+	for (S32 i = 0; i < iteration_count; i++)
+	{
+		state.BeginCounters();
+		state.BeginSample();
+
+		for (PtrSize offset = 0; offset < frame_size_bytes; offset += allocation_size_bytes)
+		{
+			MemorySlice const memory = allocator.Alloc(allocation_size_bytes, 16);
+			memory.ptr[0] = 1;
+		}
+		allocator.FreeAll();
+
+		state.EndSample();
+		state.EndCounters();
+	}
+
+	state.Report(label);
+}
+
+PAW_BENCHMARK(ArenaFrameReset)
+{
+	RunFrameResetWorkload(state, {}, "4 MiB frame, decommit on reset");
+	RunFrameResetWorkload(state, {.keep_committed_bytes = MegaBytes(4)}, "4 MiB frame, keep 4 MiB committed");
+	RunFrameResetWorkload(state, {.decommit_after_frames = 120}, "4 MiB frame, decommit after 120 frames below peak");
+}
+
+// What NewSlice did for every type before trivial types got a memset
+template <typename T>
+static Slice<T> NewSlicePerItem(S32 count, IAllocator* allocator)
+{
+	MemorySlice mem = AllocMem(sizeof(T) * count, alignof(T), allocator, SrcLoc());
+	for (S32 i = 0; i < count; i++)
+	{
+		new (mem.ptr + i * sizeof(T), PlacementNewTag_t{}) T();
+	}
+	return Slice<T>{reinterpret_cast<T*>(mem.ptr), count};
+}
+
+enum class SliceInitMode : U8
+{
+	PerItem,
+	Memset,
+	Uninit,
+};
+
+static void RunNewSliceWorkload(BenchmarkState& state, S32 count, SliceInitMode mode, char const* label)
+{
+	// Keep the pages committed so the numbers are about initialization rather than page faults
+	ArenaAllocator allocator{};
+	allocator.SetRetentionPolicy({.keep_committed_bytes = sizeof(S32) * static_cast<PtrSize>(count)});
+
+	// Commit and fault the pages in once up front
+	MemorySlice const warm_up = allocator.Alloc(sizeof(S32) * static_cast<PtrSize>(count), alignof(S32));
+	TouchPages(warm_up.ptr, warm_up.size_bytes);
+	allocator.FreeAll();
+
+	S32 const iteration_count = state.GetIterationCount() < 200 ? state.GetIterationCount() : 200;
+	for (S32 i = 0; i < iteration_count; i++)
+	{
+		state.BeginSample();
+		Slice<S32> slice{};
+		switch (mode)
+		{
+			case SliceInitMode::PerItem:
+				slice = NewSlicePerItem<S32>(count, &allocator);
+				break;
+			case SliceInitMode::Memset:
+				slice = PAW_NEW_SLICE_IN(&allocator, count, S32);
+				break;
+			case SliceInitMode::Uninit:
+				slice = PAW_NEW_SLICE_UNINIT_IN(&allocator, count, S32);
+				break;
+		}
+		BenchmarkDoNotOptimize(slice.items);
+		state.EndSample();
+
+		allocator.FreeAll();
+	}
+
+	state.Report(label);
+}
+
+PAW_BENCHMARK(NewSliceInit)
+{
+	// A 2048x2048 font atlas worth of S32s
+	static constexpr S32 count = 2048 * 2048;
+	RunNewSliceWorkload(state, count, SliceInitMode::PerItem, "16 MiB S32 slice, per item placement new");
+	RunNewSliceWorkload(state, count, SliceInitMode::Memset, "16 MiB S32 slice, PAW_NEW_SLICE (memset)");
+	RunNewSliceWorkload(state, count, SliceInitMode::Uninit, "16 MiB S32 slice, PAW_NEW_SLICE_UNINIT");
+}
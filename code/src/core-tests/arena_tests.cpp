@@ -2,6 +2,10 @@
 
 #include <core/arena.h>
 #include <core/memory.inl>
+#include <core/frame_ring.h>
+#include <core/scratch.h>
+
+#include <thread>
 
 #define PAW_TEST_MODULE_NAME Arena
 
@@ -92,12 +96,50 @@ PAW_TEST(PagedArenaAllocator)
 	PAW_NEW_SLICE(10, Byte);
 	PAW_NEW_SLICE(allocator.GetFreeBytesInPage(), Byte);
 	Slice<Byte> const alloc = PAW_NEW_SLICE(10, Byte);
-	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 2);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetBlockCount(), 2);
+	// The second block is twice the size of the first
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 3);
 	PAW_DELETE_SLICE(alloc);
 	allocator.FreeAll();
 	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 0);
 }
 
+PAW_TEST(PagedArenaAllocatorDedicatedSpans)
+{
+	PagedArenaAllocator allocator{};
+
+	MemorySlice const small = allocator.Alloc(64, 8);
+	PtrSize const free_bytes = allocator.GetFreeBytesInPage();
+	ArenaMarker_t const marker = allocator.GetMarker();
+
+	// Far bigger than a page, gets its own span and the current block keeps going
+	MemorySlice const large = allocator.Alloc(MegaBytes(3), 16);
+	PAW_TEST_EXPECT(large.ptr != nullptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetBlockCount(), 2);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytesInPage(), free_bytes);
+	MemorySlice const after_large = allocator.Alloc(64, 8);
+	PAW_TEST_EXPECT_EQUAL(after_large.ptr, small.ptr + 64);
+
+	// Rewinding drops the span as well, it was made after the marker
+	allocator.FreeToMarker(marker);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetBlockCount(), 1);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytesInPage(), free_bytes);
+
+	// Freeing the newest span hands its pages straight back
+	S32 const page_count = allocator.GetPageCount();
+	MemorySlice const span = allocator.Alloc(MegaBytes(1), 16);
+	PAW_TEST_EXPECT(allocator.GetPageCount() > page_count);
+	allocator.Free(span);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), page_count);
+
+	// No cap on the block count any more
+	for (S32 i = 0; i < 64; i++)
+	{
+		PAW_TEST_EXPECT(allocator.Alloc(MegaBytes(1), 8).ptr != nullptr);
+	}
+	PAW_TEST_EXPECT_EQUAL(allocator.GetBlockCount(), 65);
+}
+
 PAW_TEST(ArenaAllocator)
 {
 	ArenaAllocator allocator{};
@@ -109,14 +151,15 @@ PAW_TEST(ArenaAllocator)
 	PAW_TEST_EXPECT_EQUAL(ints.count, 4);
 	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 1);
 
-	// ArenaMarker_t const marker = allocator.GetMarker();
+	ArenaMarker_t const marker = allocator.GetMarker();
 
 	Slice<S32> const ints2 = PAW_NEW_SLICE(4, S32);
 	PAW_TEST_EXPECT_EQUAL(ints2.count, 4);
 	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 1);
 
-	// allocator.FreeToMarker(marker);
-	// PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 1);
+	allocator.FreeToMarker(marker);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 1);
+	PAW_TEST_EXPECT_EQUAL(PAW_NEW_SLICE(4, S32).items, ints2.items);
 
 	allocator.FreeAll();
 	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 0);
@@ -131,4 +174,264 @@ PAW_TEST(ArenaAllocator)
 	PAW_DELETE_SLICE(alloc);
 	allocator.FreeAll();
 	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 0);
-}
\ No newline at end of file
+}
+
+PAW_TEST(ArenaAllocatorFreeToMarker)
+{
+	ArenaAllocator allocator{};
+
+	allocator.Alloc(16, 8);
+	ArenaMarker_t const marker = allocator.GetMarker();
+	MemorySlice const large = allocator.Alloc(KiloBytes(256), 8);
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+
+	allocator.FreeToMarker(marker);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+	PAW_TEST_EXPECT_EQUAL(allocator.Alloc(KiloBytes(256), 8).ptr, large.ptr);
+
+	allocator.FreeToMarker(marker, true);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 1);
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() < committed_bytes);
+}
+
+PAW_TEST(ArenaTempScope)
+{
+	ArenaAllocator allocator{};
+	MemorySlice const before = allocator.Alloc(16, 8);
+
+	Byte* first_temp_ptr = nullptr;
+	{
+		ArenaTempScope const outer{allocator};
+		first_temp_ptr = allocator.Alloc(64, 8).ptr;
+		{
+			ArenaTempScope const inner{allocator};
+			allocator.Alloc(KiloBytes(128), 8);
+		}
+		PAW_TEST_EXPECT_EQUAL(allocator.GetMarker().head, static_cast<PtrSize>(first_temp_ptr + 64 - before.ptr));
+	}
+
+	PAW_TEST_EXPECT_EQUAL(allocator.GetMarker().head, 16ull);
+	PAW_TEST_EXPECT_EQUAL(allocator.Alloc(64, 8).ptr, first_temp_ptr);
+}
+
+PAW_TEST(PagedArenaAllocatorFreeLast)
+{
+	PagedArenaAllocator allocator{};
+
+	MemorySlice const first = allocator.Alloc(32, 8);
+	MemorySlice const second = allocator.Alloc(32, 8);
+	PtrSize const free_bytes = allocator.GetFreeBytesInPage();
+
+	// Freeing anything but the last allocation does nothing
+	allocator.Free(first);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytesInPage(), free_bytes);
+
+	allocator.Free(second);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytesInPage(), free_bytes + 32);
+	PAW_TEST_EXPECT_EQUAL(allocator.Alloc(32, 8).ptr, second.ptr);
+}
+
+PAW_TEST(ConcurrentArenaAllocator)
+{
+	static constexpr S32 thread_count = 4;
+	static constexpr S32 allocation_count = 20000;
+
+	ConcurrentArenaAllocator allocator{};
+	Slice<U32>* const allocations = new Slice<U32>[thread_count * allocation_count];
+
+	std::thread threads[thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index] = std::thread([&allocator, allocations, thread_index]() {
+			for (S32 i = 0; i < allocation_count; i++)
+			{
+				S32 const count = 1 + (i % 7);
+				MemorySlice const memory = allocator.Alloc(count * sizeof(U32), 16);
+				Slice<U32> const items{reinterpret_cast<U32*>(memory.ptr), count};
+				for (U32& item : items)
+				{
+					item = static_cast<U32>(thread_index * allocation_count + i);
+				}
+				allocations[thread_index * allocation_count + i] = items;
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Overlapping allocations would have overwritten each other's values
+	bool all_intact = true;
+	for (S32 i = 0; i < thread_count * allocation_count; i++)
+	{
+		all_intact &= IsPointerAligned(reinterpret_cast<Byte const*>(allocations[i].items), 16);
+		for (U32 const item : allocations[i])
+		{
+			all_intact &= item == static_cast<U32>(i);
+		}
+	}
+	PAW_TEST_EXPECT(all_intact);
+	delete[] allocations;
+
+	// 16 byte aligned allocations are packed without padding, only bigger alignments add any
+	PtrSize expected_used_Bytes = 0;
+	for (S32 i = 0; i < allocation_count; i++)
+	{
+		expected_used_Bytes += AlignSizeForward((1 + (i % 7)) * sizeof(U32), 16);
+	}
+	PAW_TEST_EXPECT_EQUAL(allocator.GetUsedBytes(), expected_used_Bytes * thread_count);
+
+	MemorySlice const over_aligned = allocator.Alloc(24, 256);
+	PAW_TEST_EXPECT(IsPointerAligned(over_aligned.ptr, 256));
+	PAW_TEST_EXPECT(IsPointerAligned(allocator.Alloc(8, 8).ptr, 16));
+
+	allocator.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(allocator.GetUsedBytes(), 0ull);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), 0ull);
+}
+
+PAW_TEST(FrameRingAllocator)
+{
+	static constexpr U64 frames_in_flight = 3;
+	static constexpr S32 allocations_per_frame = 4;
+	static constexpr PtrSize allocation_size = KiloBytes(10);
+
+	FrameRingAllocator allocator{KiloBytes(64)};
+	Byte* frame_allocations[frames_in_flight][allocations_per_frame]{};
+
+	bool all_intact = true;
+	for (U64 frame = 1; frame <= 64; frame++)
+	{
+		allocator.BeginFrame(frame);
+		if (frame > frames_in_flight)
+		{
+			// Everything the oldest frame wrote must have survived until it retires
+			Byte* const* const oldest = frame_allocations[frame % frames_in_flight];
+			for (S32 i = 0; i < allocations_per_frame; i++)
+			{
+				all_intact &= oldest[i][0] == static_cast<Byte>(frame - frames_in_flight) && oldest[i][allocation_size - 1] == static_cast<Byte>(frame - frames_in_flight);
+			}
+			allocator.RetireFrames(frame - frames_in_flight);
+		}
+
+		for (S32 i = 0; i < allocations_per_frame; i++)
+		{
+			MemorySlice const memory = allocator.Alloc(allocation_size, 16);
+			std::memset(memory.ptr, static_cast<int>(frame), memory.size_bytes);
+			frame_allocations[frame % frames_in_flight][i] = memory.ptr;
+		}
+	}
+	PAW_TEST_EXPECT(all_intact);
+
+	FrameRingStats const stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(stats.last_frame_bytes, allocations_per_frame * allocation_size);
+	PAW_TEST_EXPECT(stats.committed_bytes <= KiloBytes(256));
+
+	// Bigger than a chunk gets a chunk of its own
+	PAW_TEST_EXPECT(allocator.Alloc(MegaBytes(1), 16).ptr != nullptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetStats().chunk_count, stats.chunk_count + 1);
+}
+
+PAW_TEST(ArenaAllocatorRetention)
+{
+	ArenaAllocator allocator{};
+	ScopedDefaultAllocator allocator_scope{&allocator};
+
+	allocator.SetRetentionPolicy({.keep_committed_bytes = KiloBytes(128)});
+	PAW_NEW_SLICE(KiloBytes(192), Byte);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(192));
+	allocator.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 0);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(128));
+
+	allocator.SetRetentionPolicy({.decommit_after_frames = 2});
+	PAW_NEW_SLICE(KiloBytes(192), Byte);
+	allocator.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(192));
+
+	// Two frames in a row that peak below the committed size trim it down to the last peak
+	PAW_NEW_SLICE(KiloBytes(16), Byte);
+	allocator.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(192));
+	PAW_NEW_SLICE(KiloBytes(16), Byte);
+	allocator.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(64));
+}
+
+PAW_TEST(ArenaAllocatorResize)
+{
+	ArenaAllocator allocator{};
+
+	MemorySlice const first = allocator.Alloc(64, 16);
+	MemorySlice const second = allocator.Alloc(64, 16);
+
+	// Only the most recent allocation grows in place
+	PAW_TEST_EXPECT_NOT(allocator.TryResize(first, 128));
+	PAW_TEST_EXPECT(allocator.TryResize(first, 32));
+
+	// Growing past the committed pages commits more
+	PAW_TEST_EXPECT(allocator.TryResize(second, KiloBytes(200)));
+	PAW_TEST_EXPECT_EQUAL(allocator.GetPageCount(), 4);
+	second.ptr[KiloBytes(200) - 1] = 1;
+
+	PAW_TEST_EXPECT(allocator.TryResize({second.ptr, KiloBytes(200)}, 16));
+	MemorySlice const third = allocator.Alloc(16, 16);
+	PAW_TEST_EXPECT(third.ptr == second.ptr + 16);
+
+	// Falls back to a copy when the allocation isn't the most recent one
+	first.ptr[0] = 42;
+	MemorySlice const moved = PAW_RESIZE_IN(&allocator, first, 256, 16);
+	PAW_TEST_EXPECT(moved.ptr != first.ptr);
+	PAW_TEST_EXPECT_EQUAL(moved.ptr[0], static_cast<Byte>(42));
+}
+
+PAW_TEST(FixedSizeArenaAllocatorResize)
+{
+	Byte buffer[64];
+	FixedSizeArenaAllocator allocator{buffer, sizeof(buffer)};
+
+	MemorySlice const memory = allocator.Alloc(16, 1);
+	PAW_TEST_EXPECT(allocator.TryResize(memory, 48));
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytes(), 16ull);
+	PAW_TEST_EXPECT_NOT(allocator.TryResize({memory.ptr, 48}, 128));
+	PAW_TEST_EXPECT(allocator.TryResize({memory.ptr, 48}, 8));
+	PAW_TEST_EXPECT_EQUAL(allocator.GetFreeBytes(), 56ull);
+}
+
+PAW_TEST(ScratchScopeNesting)
+{
+	Byte* first_ptr = nullptr;
+	{
+		ScratchScope const outer{};
+		first_ptr = outer.GetAllocator()->Alloc(64, 8).ptr;
+
+		ScratchScope const inner{outer.GetAllocator()};
+		PAW_TEST_EXPECT(inner.GetAllocator() != outer.GetAllocator());
+
+		// One level deeper goes back to the outer arena, on top of everything the outer scope allocated
+		ScratchScope const nested{inner.GetAllocator()};
+		PAW_TEST_EXPECT_EQUAL(nested.GetAllocator(), outer.GetAllocator());
+	}
+
+	ScratchScope const rewound{};
+	PAW_TEST_EXPECT_EQUAL(rewound.GetAllocator()->Alloc(64, 8).ptr, first_ptr);
+}
+
+PAW_TEST(ScratchScopeReleasesLargeTemporaries)
+{
+	IAllocator* arena = nullptr;
+	{
+		ScratchScope const outer{};
+		arena = outer.GetAllocator();
+		{
+			// Nested scopes keep their pages for the next allocations
+			ScratchScope const nested{};
+			PAW_TEST_EXPECT(nested.GetAllocator()->Alloc(MegaBytes(4), 16).ptr != nullptr);
+		}
+		PAW_TEST_EXPECT(arena->GetCommittedBytes() >= MegaBytes(4));
+	}
+
+	PAW_TEST_EXPECT(arena->GetCommittedBytes() <= ScratchScope::keep_committed_bytes);
+}
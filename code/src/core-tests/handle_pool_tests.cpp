@@ -0,0 +1,105 @@
+#include <testing/testing.h>
+
+#include <core/arena.h>
+#include <core/handle_pool.h>
+#include <core/tlsf.h>
+
+#define PAW_TEST_MODULE_NAME HandlePool
+
+struct PoolItem
+{
+	S32 value = 0;
+};
+
+PAW_TEST(HandlePoolAllocFree)
+{
+	TLSFAllocator allocator{};
+	HandlePool<PoolItem> pool{&allocator};
+
+	Handle<PoolItem> const first = pool.Alloc(PoolItem{1});
+	Handle<PoolItem> const second = pool.Alloc(PoolItem{2});
+	PAW_TEST_EXPECT_EQUAL(pool.GetValue(first).value, 1);
+	PAW_TEST_EXPECT_EQUAL(pool.GetValue(second).value, 2);
+	PAW_TEST_EXPECT_NOT(pool.IsValid(HandlePool<PoolItem>::null_handle));
+	PAW_TEST_EXPECT_NOT(pool.IsValid(Handle<PoolItem>{0, 0}));
+
+	// The freed index is reused with a new generation, the old handle stays invalid
+	pool.Free(first);
+	PAW_TEST_EXPECT_NOT(pool.IsValid(first));
+	Handle<PoolItem> const third = pool.Alloc(PoolItem{3});
+	PAW_TEST_EXPECT_EQUAL(third.index, first.index);
+	PAW_TEST_EXPECT(third.generation != first.generation);
+	PAW_TEST_EXPECT_NOT(pool.IsValid(first));
+	PAW_TEST_EXPECT(pool.IsValid(third));
+	PAW_TEST_EXPECT_EQUAL(pool.GetValue(second).value, 2);
+	PAW_TEST_EXPECT_EQUAL(pool.GetValue(third).value, 3);
+	PAW_TEST_EXPECT_EQUAL(pool.GetCount(), 2);
+}
+
+PAW_TEST(HandlePoolGrowKeepsHandles)
+{
+	TLSFAllocator allocator{};
+	HandlePool<PoolItem> pool{&allocator, 4};
+
+	static constexpr S32 item_count = 1000;
+	Handle<PoolItem> handles[item_count];
+	for (S32 i = 0; i < item_count; i++)
+	{
+		handles[i] = pool.Alloc(PoolItem{i});
+	}
+
+	bool all_found = true;
+	for (S32 i = 0; i < item_count; i++)
+	{
+		all_found &= pool.IsValid(handles[i]) && pool.GetValue(handles[i]).value == i;
+	}
+	PAW_TEST_EXPECT(all_found);
+}
+
+PAW_TEST(HandlePoolDenseIteration)
+{
+	ArenaAllocator allocator{};
+	HandlePool<PoolItem> pool{&allocator};
+
+	static constexpr S32 item_count = 100;
+	Handle<PoolItem> handles[item_count];
+	for (S32 i = 0; i < item_count; i++)
+	{
+		handles[i] = pool.Alloc(PoolItem{i});
+	}
+
+	// Freeing moves the last item into the hole, so the live items stay packed
+	S32 expected_sum = 0;
+	for (S32 i = 0; i < item_count; i++)
+	{
+		if (i % 3 == 0)
+		{
+			pool.Free(handles[i]);
+		}
+		else
+		{
+			expected_sum += i;
+		}
+	}
+	PAW_TEST_EXPECT_EQUAL(pool.GetCount(), item_count - (item_count + 2) / 3);
+
+	S32 sum = 0;
+	for (PoolItem const& item : pool)
+	{
+		sum += item.value;
+	}
+	PAW_TEST_EXPECT_EQUAL(sum, expected_sum);
+
+	bool handles_match = true;
+	Slice<PoolItem> const items = pool.GetItems();
+	for (S32 position = 0; position < items.count; position++)
+	{
+		Handle<PoolItem> const handle = pool.GetHandle(position);
+		handles_match &= handle == handles[items[position].value];
+	}
+	PAW_TEST_EXPECT(handles_match);
+
+	pool.Clear();
+	PAW_TEST_EXPECT_EQUAL(pool.GetCount(), 0);
+	PAW_TEST_EXPECT_NOT(pool.IsValid(handles[1]));
+}
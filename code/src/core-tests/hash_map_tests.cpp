@@ -0,0 +1,153 @@
+#include <testing/testing.h>
+
+#include <core/hash_map.h>
+#include <core/tlsf.h>
+
+#define PAW_TEST_MODULE_NAME HashMap
+
+PAW_TEST(HashMapAddFindRemove)
+{
+	TLSFAllocator allocator{};
+	HashMap<U64, S32> map{&allocator};
+
+	PAW_TEST_EXPECT(map.Find(1) == nullptr);
+	PAW_TEST_EXPECT_NOT(map.Remove(1));
+
+	bool added = false;
+	map.FindOrAdd(1, &added) = 10;
+	PAW_TEST_EXPECT(added);
+	map.FindOrAdd(1, &added) += 1;
+	PAW_TEST_EXPECT_NOT(added);
+	map.Set(2, 20);
+	map.Set(2, 21);
+
+	PAW_TEST_EXPECT_EQUAL(map.GetCount(), 2);
+	PAW_TEST_EXPECT_EQUAL(*map.Find(1), 11);
+	PAW_TEST_EXPECT_EQUAL(*map.Find(2), 21);
+	PAW_TEST_EXPECT_NOT(map.Contains(3));
+
+	PAW_TEST_EXPECT(map.Remove(1));
+	PAW_TEST_EXPECT_NOT(map.Contains(1));
+	PAW_TEST_EXPECT(map.Contains(2));
+	PAW_TEST_EXPECT_EQUAL(map.GetCount(), 1);
+}
+
+// Random adds and removes checked against a plain array, with keys that all land in a few home groups so the runs get
+// long and removal has to shift entries across group and wrap around boundaries
+PAW_TEST(HashMapChurnMatchesReference)
+{
+	struct CollidingTraits
+	{
+		static U64 Hash(U32 const& key)
+		{
+			return (static_cast<U64>(key % 5) << 7) * 123 + (key & 0x7F);
+		}
+
+		static bool Equal(U32 const& a, U32 const& b)
+		{
+			return a == b;
+		}
+	};
+
+	TLSFAllocator allocator{};
+	HashMap<U32, U32, CollidingTraits> map{&allocator};
+
+	static constexpr U32 key_range = 512;
+	bool present[key_range]{};
+	S32 present_count = 0;
+	U64 random = 0x9E3779B97F4A7C15ull;
+	bool all_match = true;
+	for (S32 step = 0; step < 20000; step++)
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		U32 const key = static_cast<U32>(random >> 33) % key_range;
+		if (present[key])
+		{
+			all_match &= map.Remove(key);
+			present[key] = false;
+			present_count--;
+		}
+		else
+		{
+			map.Set(key, key * 3);
+			present[key] = true;
+			present_count++;
+		}
+
+		if (step % 97 == 0)
+		{
+			for (U32 check_key = 0; check_key < key_range; check_key++)
+			{
+				U32 const* value = map.Find(check_key);
+				all_match &= present[check_key] ? value != nullptr && *value == check_key * 3 : value == nullptr;
+			}
+		}
+	}
+
+	PAW_TEST_EXPECT(all_match);
+	PAW_TEST_EXPECT_EQUAL(map.GetCount(), present_count);
+
+	S32 visited = 0;
+	map.ForEach([&](U32 const& key, U32& value) {
+		all_match &= present[key] && value == key * 3;
+		visited++;
+	});
+	PAW_TEST_EXPECT(all_match);
+	PAW_TEST_EXPECT_EQUAL(visited, present_count);
+}
+
+PAW_TEST(HashMapStringKeysAndLifetimes)
+{
+	static S32 live_values = 0;
+	struct Counted
+	{
+		Counted()
+		{
+			live_values++;
+		}
+		Counted(Counted&& other)
+			: value(other.value)
+		{
+			live_values++;
+		}
+		Counted& operator=(Counted&& other)
+		{
+			value = other.value;
+			return *this;
+		}
+		~Counted()
+		{
+			live_values--;
+		}
+		S32 value = 0;
+	};
+
+	TLSFAllocator allocator{};
+	{
+		HashMap<StringView8, Counted> map{&allocator};
+		map.FindOrAdd(PAW_STR("alpha")).value = 1;
+		map.FindOrAdd(PAW_STR("beta")).value = 2;
+		map.FindOrAdd(PAW_STR("")).value = 3;
+
+		// A different pointer to the same bytes finds the same entry
+		char const other_alpha[] = "alpha";
+		StringView8 const alpha{.ptr = reinterpret_cast<Byte const*>(other_alpha), .size_bytes = 5};
+		PAW_TEST_EXPECT_EQUAL(map.Find(alpha)->value, 1);
+		PAW_TEST_EXPECT_EQUAL(map.Find(PAW_STR(""))->value, 3);
+		PAW_TEST_EXPECT(map.Find(PAW_STR("alph")) == nullptr);
+
+		map.Reserve(1000);
+		PAW_TEST_EXPECT(map.GetCapacity() >= 1000);
+		PAW_TEST_EXPECT_EQUAL(map.Find(PAW_STR("beta"))->value, 2);
+		PAW_TEST_EXPECT_EQUAL(live_values, 3);
+
+		map.Remove(PAW_STR("beta"));
+		PAW_TEST_EXPECT_EQUAL(live_values, 2);
+		map.Clear();
+		PAW_TEST_EXPECT_EQUAL(live_values, 0);
+		PAW_TEST_EXPECT_EQUAL(map.GetCount(), 0);
+
+		map.FindOrAdd(PAW_STR("gamma")).value = 4;
+	}
+	PAW_TEST_EXPECT_EQUAL(live_values, 0);
+}
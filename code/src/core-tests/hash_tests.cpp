@@ -0,0 +1,136 @@
+#include <testing/testing.h>
+
+#include <core/hash.h>
+
+#define PAW_TEST_MODULE_NAME Hash
+
+static_assert(HashLiteral("") != HashLiteral("a"));
+static_assert(HashLiteral("pass") != HashLiteral("pass", 1));
+
+// Sizes on both sides of every path switch: short, 16 byte chunks, bulk stripes and a block scramble
+static constexpr PtrSize g_hash_test_sizes[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 32, 100, 255, 256, 257, 320, 1023, 1024, 1025, 5000};
+
+static void FillTestBytes(Byte* bytes, PtrSize size_bytes)
+{
+	U64 random = 0x2545F4914F6CDD1Dull;
+	for (PtrSize i = 0; i < size_bytes; i++)
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		bytes[i] = static_cast<Byte>(random >> 56);
+	}
+}
+
+PAW_TEST(HashLiteralMatchesRuntime)
+{
+	PAW_TEST_EXPECT_EQUAL(HashLiteral(""), Hash64(PAW_STR("")));
+	PAW_TEST_EXPECT_EQUAL(HashLiteral("abc"), Hash64(PAW_STR("abc")));
+	PAW_TEST_EXPECT_EQUAL(HashLiteral("GraphTexture"), Hash64(PAW_STR("GraphTexture")));
+	PAW_TEST_EXPECT_EQUAL(HashLiteral("Scene view color render target"), Hash64(PAW_STR("Scene view color render target")));
+	PAW_TEST_EXPECT_EQUAL(HashLiteral("abc", 7), Hash64(PAW_STR("abc"), 7));
+
+	// Long enough for the SIMD bulk path at runtime, the compile time value comes from the scalar one
+	constexpr U64 long_hash = HashLiteral(
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+		"The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. ");
+	PAW_TEST_EXPECT_EQUAL(long_hash, Hash64(PAW_STR(
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. "
+									 "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog. ")));
+}
+
+PAW_TEST(HashSimdMatchesScalar)
+{
+	Byte bytes[5000];
+	FillTestBytes(bytes, sizeof(bytes));
+
+	static constexpr PtrSize stripe_counts[] = {1, 15, 16, 17, 78};
+	bool all_match = true;
+	for (PtrSize stripe_count : stripe_counts)
+	{
+		U64 simd_acc[8];
+		U64 scalar_acc[8];
+		HashInitAccumulators(simd_acc, 3);
+		HashInitAccumulators(scalar_acc, 3);
+		U32 simd_block_stripe = 5;
+		U32 scalar_block_stripe = 5;
+		HashAccumulateSimd(simd_acc, bytes, stripe_count, simd_block_stripe);
+		HashAccumulateScalar(scalar_acc, bytes, stripe_count, scalar_block_stripe);
+
+		all_match &= simd_block_stripe == scalar_block_stripe;
+		for (S32 i = 0; i < 8; i++)
+		{
+			all_match &= simd_acc[i] == scalar_acc[i];
+		}
+	}
+	PAW_TEST_EXPECT(all_match);
+}
+
+PAW_TEST(HashStreamMatchesOneShot)
+{
+	Byte bytes[5000];
+	FillTestBytes(bytes, sizeof(bytes));
+
+	static constexpr PtrSize piece_sizes[] = {1, 13, 64, 300, 4096};
+	bool all_match = true;
+	for (PtrSize size_bytes : g_hash_test_sizes)
+	{
+		U64 const expected = Hash64(bytes, size_bytes, 11);
+		for (PtrSize piece_size_bytes : piece_sizes)
+		{
+			Hash64Stream stream{11};
+			for (PtrSize offset = 0; offset < size_bytes; offset += piece_size_bytes)
+			{
+				stream.Update(bytes + offset, size_bytes - offset < piece_size_bytes ? size_bytes - offset : piece_size_bytes);
+			}
+			all_match &= stream.Finish() == expected;
+		}
+	}
+	PAW_TEST_EXPECT(all_match);
+}
+
+// Flipping any single input bit should flip about half of the output bits, checked on average per size
+PAW_TEST(HashBitAvalanche)
+{
+	Byte bytes[1025];
+	FillTestBytes(bytes, sizeof(bytes));
+
+	bool all_good = true;
+	for (PtrSize size_bytes : g_hash_test_sizes)
+	{
+		if (size_bytes == 0 || size_bytes > sizeof(bytes))
+		{
+			continue;
+		}
+
+		U64 const base = Hash64(bytes, size_bytes);
+		S32 flipped_bits = 0;
+		S32 flip_count = 0;
+		for (PtrSize bit = 0; bit < size_bytes * 8; bit += 1 + size_bytes / 16)
+		{
+			bytes[bit / 8] ^= static_cast<Byte>(1 << (bit % 8));
+			flipped_bits += __builtin_popcountll(base ^ Hash64(bytes, size_bytes));
+			bytes[bit / 8] ^= static_cast<Byte>(1 << (bit % 8));
+			flip_count++;
+		}
+		F32 const average = static_cast<F32>(flipped_bits) / static_cast<F32>(flip_count);
+		all_good &= average > 28.0f && average < 36.0f;
+	}
+	PAW_TEST_EXPECT(all_good);
+}
+
+PAW_TEST(HashCombineOrder)
+{
+	U64 const a = HashU64(1);
+	U64 const b = HashU64(2);
+	PAW_TEST_EXPECT(a != b);
+	PAW_TEST_EXPECT(HashCombine(a, b) != HashCombine(b, a));
+	PAW_TEST_EXPECT(HashCombine(HashCombine(0, a), b) != HashCombine(HashCombine(0, b), a));
+	PAW_TEST_EXPECT(HashCombine(0, 0) != HashCombine(0, 1));
+}
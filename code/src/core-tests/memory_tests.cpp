@@ -1,7 +1,14 @@
+#include <core/arena.h>
 #include <core/memory.inl>
+#include <core/memory_budget.h>
+#include <core/memory_tracking.h>
+#include <core/tlsf.h>
 
 #include <testing/testing.h>
 
+#include <atomic>
+#include <thread>
+
 PAW_TEST(IsPointerAligned)
 {
 	for (PtrSize i = 0; i < (1ull << 16ull); i++)
@@ -43,4 +50,304 @@ PAW_TEST(IsPointerAligned)
 			PAW_TEST_EXPECT_NOT(IsPointerAligned(ptr, 32));
 		}
 	}
-}
\ No newline at end of file
+}
+
+class CountingAllocator final : public IAllocator
+{
+public:
+	MemorySlice Alloc(PtrSize size_bytes, PtrSize /*alignment*/) override
+	{
+		if (GetPageCount() == 0)
+		{
+			AllocPages(1);
+		}
+		return {GetBaseAddress(), size_bytes};
+	}
+
+	void Free(MemorySlice /*memory*/) override
+	{
+		free_count++;
+	}
+
+	S32 free_count = 0;
+};
+
+PAW_TEST(AllocatorRegistrationStress)
+{
+	static constexpr S32 thread_count = 16;
+	static constexpr S32 iteration_count = 2000;
+
+	std::atomic<S32> failure_count = 0;
+	std::thread threads[thread_count];
+	for (std::thread& thread : threads)
+	{
+		thread = std::thread([&failure_count]
+							 {
+			for (S32 i = 0; i < iteration_count; i++)
+			{
+				CountingAllocator allocator{};
+				MemorySlice const memory = allocator.Alloc(16, 16);
+				memory.ptr[0] = 1;
+
+				// Resolves the allocator through the pointer -> slot lookup, which must find this thread's allocator
+				// even while other threads are taking and returning slots
+				FreeMem(memory, nullptr, SrcLoc());
+				if (allocator.free_count != 1)
+				{
+					failure_count++;
+				}
+			} });
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	PAW_TEST_EXPECT_EQUAL(failure_count.load(), 0);
+}
+
+PAW_TEST(MemoryTrackingCallsites)
+{
+	ArenaAllocator allocator{};
+	ArenaAllocator snapshot_allocator{};
+
+	MemoryTrackingReset();
+	MemoryTrackingStart();
+
+	S32 const allocator_index = allocator.GetAllocatorIndex();
+	MemorySlice kept{};
+	for (S32 i = 0; i < 4; i++)
+	{
+		MemorySlice const memory = PAW_ALLOC_IN(&allocator, 64);
+		if (i == 0)
+		{
+			kept = memory;
+		}
+		else
+		{
+			FreeMem(memory, &allocator, SrcLoc());
+		}
+	}
+
+	MemoryTrackingStop();
+
+	Slice<MemoryCallsiteStats> const callsites = MemoryTrackingGetCallsites(&snapshot_allocator);
+	PAW_TEST_EXPECT_EQUAL(callsites.count, 1);
+	PAW_TEST_EXPECT_EQUAL(callsites[0].allocation_count, 4ull);
+	PAW_TEST_EXPECT_EQUAL(callsites[0].free_count, 3ull);
+	PAW_TEST_EXPECT_EQUAL(callsites[0].total_bytes, 256ull);
+	PAW_TEST_EXPECT_EQUAL(callsites[0].live_bytes, 64ull);
+	PAW_TEST_EXPECT_EQUAL(callsites[0].peak_live_bytes, 128ull);
+
+	Slice<MemoryAllocatorStats> const allocators = MemoryTrackingGetAllocators(&snapshot_allocator);
+	PAW_TEST_EXPECT_EQUAL(allocators.count, 1);
+	PAW_TEST_EXPECT_EQUAL(allocators[0].allocator_index, allocator_index);
+	PAW_TEST_EXPECT_EQUAL(allocators[0].live_bytes, kept.size_bytes);
+	PAW_TEST_EXPECT(allocators[0].peak_committed_bytes > 0);
+
+	MemoryTrackingReset();
+}
+
+PAW_TEST(MemoryTrackingCrossThreadFree)
+{
+	static constexpr S32 allocation_count = 1000;
+
+	TLSFAllocator allocator{};
+	ArenaAllocator snapshot_allocator{};
+	MemorySlice allocations[allocation_count]{};
+	std::atomic<S32> stage = 0;
+
+	MemoryTrackingReset();
+	MemoryTrackingStart();
+
+	// Both threads fill their buffers a few times over, so the frees get handed over while some of the allocations they
+	// free are still buffered. The allocating thread stays alive with the rest buffered while the other thread flushes.
+	std::thread allocating_thread([&]() {
+		for (MemorySlice& allocation : allocations)
+		{
+			allocation = PAW_ALLOC_IN(&allocator, 64);
+		}
+		stage = 1;
+		while (stage.load() != 2)
+		{
+			std::this_thread::yield();
+		}
+	});
+	std::thread freeing_thread([&]() {
+		while (stage.load() != 1)
+		{
+			std::this_thread::yield();
+		}
+		for (MemorySlice const& allocation : allocations)
+		{
+			FreeMem(allocation, &allocator, SrcLoc());
+		}
+		MemoryTrackingFlush();
+		stage = 2;
+	});
+	freeing_thread.join();
+	allocating_thread.join();
+
+	// The same address handed out again after a Free the tracker never saw replaces the stale entry
+	MemorySlice const first = PAW_ALLOC_IN(&allocator, 64);
+	allocator.Free(first);
+	MemorySlice const second = PAW_ALLOC_IN(&allocator, 64);
+	PAW_TEST_EXPECT_EQUAL(second.ptr, first.ptr);
+
+	MemoryTrackingStop();
+
+	PAW_TEST_EXPECT_EQUAL(MemoryTrackingGetUntrackedFreeCount(), 0ull);
+	PAW_TEST_EXPECT_EQUAL(MemoryTrackingGetOverwrittenAllocationCount(), 1ull);
+	Slice<MemoryAllocatorStats> const allocators = MemoryTrackingGetAllocators(&snapshot_allocator);
+	PAW_TEST_EXPECT_EQUAL(allocators.count, 1);
+	PAW_TEST_EXPECT_EQUAL(allocators[0].live_bytes, second.size_bytes);
+
+	FreeMem(second, &allocator, SrcLoc());
+	MemoryTrackingReset();
+}
+
+PAW_TEST(MemoryTrackingArenaReset)
+{
+	ArenaAllocator reset_allocator{};
+	ArenaAllocator kept_allocator{};
+	ArenaAllocator snapshot_allocator{};
+
+	MemoryTrackingReset();
+	MemoryTrackingStart();
+
+	for (S32 i = 0; i < 8; i++)
+	{
+		PAW_ALLOC_IN(&reset_allocator, 128);
+		PAW_ALLOC_IN(&kept_allocator, 64);
+	}
+
+	// Only the allocations of the arena being reset are dropped
+	reset_allocator.FreeAll();
+
+	MemoryTrackingStop();
+
+	Slice<MemoryAllocatorStats> const allocators = MemoryTrackingGetAllocators(&snapshot_allocator);
+	PAW_TEST_EXPECT_EQUAL(allocators.count, 2);
+	for (MemoryAllocatorStats const& stats : allocators)
+	{
+		U64 const expected_live_bytes = stats.allocator_index == kept_allocator.GetAllocatorIndex() ? 8 * 64ull : 0ull;
+		PAW_TEST_EXPECT_EQUAL(stats.live_bytes, expected_live_bytes);
+	}
+
+	MemoryTrackingReset();
+}
+
+PAW_TEST(MemoryTrackingPages)
+{
+	ArenaAllocator allocator{};
+	ArenaAllocator snapshot_allocator{};
+	allocator.SetRetentionPolicy({.keep_committed_bytes = MegaBytes(1)});
+
+	MemoryTrackingReset();
+	MemoryTrackingStart();
+
+	// Allocations that skip AllocMem still show up through the pages they take
+	allocator.Alloc(KiloBytes(256), 16);
+	allocator.FreeAll();
+
+	MemoryTrackingStop();
+
+	Slice<MemoryAllocatorStats> const allocators = MemoryTrackingGetAllocators(&snapshot_allocator);
+	PAW_TEST_EXPECT_EQUAL(allocators.count, 1);
+	PAW_TEST_EXPECT_EQUAL(allocators[0].page_bytes, 0ull);
+	PAW_TEST_EXPECT(allocators[0].peak_page_bytes >= KiloBytes(256));
+	PAW_TEST_EXPECT(allocators[0].committed_bytes >= KiloBytes(256));
+	PAW_TEST_EXPECT_EQUAL(allocators[0].live_bytes, 0ull);
+
+	MemoryTrackingReset();
+}
+
+static void CountSoftLimitHits(MemoryCategory /*category*/, PtrSize /*committed_bytes*/, void* user_data)
+{
+	(*static_cast<S32*>(user_data))++;
+}
+
+PAW_TEST(MemoryBudgetLimits)
+{
+	S32 soft_limit_hit_count = 0;
+	MemorySetCategoryBudget(MemoryCategory::Fonts, {
+													   .soft_limit_bytes = KiloBytes(128),
+													   .hard_limit_bytes = KiloBytes(256),
+													   .on_soft_limit = CountSoftLimitHits,
+													   .user_data = &soft_limit_hit_count,
+												   });
+
+	{
+		ArenaAllocator allocator{};
+		allocator.SetMemoryCategory(MemoryCategory::Fonts);
+
+		PtrSize const total_committed_bytes = MemoryGetCommittedBytes();
+		MemorySlice const first = PAW_ALLOC_IN(&allocator, KiloBytes(128));
+		PAW_TEST_EXPECT(first.ptr != nullptr);
+		PAW_TEST_EXPECT_EQUAL(soft_limit_hit_count, 1);
+		PAW_TEST_EXPECT_EQUAL(MemoryGetCommittedBytes(MemoryCategory::Fonts), KiloBytes(128));
+		PAW_TEST_EXPECT_EQUAL(MemoryGetCommittedBytes(), total_committed_bytes + KiloBytes(128));
+
+		// Over the category's hard limit, the allocation fails without committing anything
+		MemorySlice const second = PAW_ALLOC_IN(&allocator, KiloBytes(192));
+		PAW_TEST_EXPECT(second.ptr == nullptr);
+		PAW_TEST_EXPECT_EQUAL(MemoryGetCommittedBytes(MemoryCategory::Fonts), KiloBytes(128));
+
+		Slice<S32> const ints = PAW_NEW_SLICE_IN(&allocator, KiloBytes(64), S32);
+		PAW_TEST_EXPECT_EQUAL(ints.count, 0);
+
+		// Per allocator limits apply on top of the category's
+		allocator.SetCommitLimit(KiloBytes(192));
+		MemorySlice const third = PAW_ALLOC_IN(&allocator, KiloBytes(96));
+		PAW_TEST_EXPECT(third.ptr == nullptr);
+	}
+
+	PAW_TEST_EXPECT_EQUAL(MemoryGetCommittedBytes(MemoryCategory::Fonts), 0ull);
+	MemorySetCategoryBudget(MemoryCategory::Fonts, {});
+}
+
+struct ConstructionCounter
+{
+	explicit ConstructionCounter(S32& construction_count)
+	{
+		construction_count++;
+		bytes[0] = 1;
+	}
+
+	Byte bytes[KiloBytes(96)];
+};
+
+PAW_TEST(NewFailsWithoutConstructing)
+{
+	ArenaAllocator allocator{};
+	allocator.SetCommitLimit(KiloBytes(64));
+
+	S32 construction_count = 0;
+	ConstructionCounter* const counter = PAW_NEW_IN(&allocator, ConstructionCounter)(construction_count);
+	PAW_TEST_EXPECT(counter == nullptr);
+	PAW_TEST_EXPECT_EQUAL(construction_count, 0);
+}
+
+PAW_TEST(NewSliceZeroesTrivialTypes)
+{
+	// Retained pages come back dirty, so the zeroes have to come from NewSlice itself
+	ArenaAllocator allocator{};
+	allocator.SetRetentionPolicy({.keep_committed_bytes = KiloBytes(64)});
+
+	Slice<S32> const dirty = PAW_NEW_SLICE_UNINIT_IN(&allocator, 1024, S32);
+	for (S32& item : dirty)
+	{
+		item = 0x7F7F7F7F;
+	}
+	allocator.FreeAll();
+
+	Slice<S32> const zeroed = PAW_NEW_SLICE_IN(&allocator, 1024, S32);
+	PAW_TEST_EXPECT(zeroed.items == dirty.items);
+	bool all_zero = true;
+	for (S32 item : zeroed)
+	{
+		all_zero = all_zero && item == 0;
+	}
+	PAW_TEST_EXPECT(all_zero);
+}
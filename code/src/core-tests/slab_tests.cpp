@@ -0,0 +1,87 @@
+#include <testing/testing.h>
+
+#include <core/slab.h>
+#include <core/memory.inl>
+
+#define PAW_TEST_MODULE_NAME Slab
+
+struct Node
+{
+	Node* next;
+	U64 value;
+	Byte payload[40];
+};
+
+PAW_TEST(SlabSlotPacking)
+{
+	// Small slots round up to a power of two so no slot straddles a cache line
+	SlabAllocator const small_slab{sizeof(Node), alignof(Node)};
+	PAW_TEST_EXPECT_EQUAL(small_slab.GetSlotStrideBytes(), PtrSize(64));
+	SlabAllocator const tiny_slab{4, 4};
+	PAW_TEST_EXPECT_EQUAL(tiny_slab.GetSlotStrideBytes(), PtrSize(8));
+
+	// Bigger slots are packed at their alignment
+	SlabAllocator const large_slab{72, 8};
+	PAW_TEST_EXPECT_EQUAL(large_slab.GetSlotStrideBytes(), PtrSize(72));
+}
+
+PAW_TEST(SlabAllocFree)
+{
+	SlabAllocator slab{sizeof(Node), alignof(Node)};
+	ScopedDefaultAllocator default_allocator{&slab};
+
+	static constexpr S32 node_count = 4096;
+	Node* nodes[node_count];
+	for (S32 i = 0; i < node_count; i++)
+	{
+		nodes[i] = PAW_NEW(Node)();
+		nodes[i]->value = static_cast<U64>(i);
+		PAW_TEST_EXPECT(IsPointerAligned(reinterpret_cast<Byte*>(nodes[i]), 64));
+	}
+	PAW_TEST_EXPECT_EQUAL(slab.GetLiveSlotCount(), node_count);
+	PAW_TEST_EXPECT_EQUAL(slab.GetCommittedBytes(), PtrSize(node_count) * 64);
+
+	bool all_intact = true;
+	for (S32 i = 0; i < node_count; i += 2)
+	{
+		all_intact &= nodes[i]->value == static_cast<U64>(i);
+		PAW_DELETE(nodes[i]);
+	}
+	PAW_TEST_EXPECT_EQUAL(slab.GetLiveSlotCount(), node_count / 2);
+
+	// Freed slots are reused newest first before any new slot is carved
+	PtrSize const committed_bytes = slab.GetCommittedBytes();
+	Node* const reused = PAW_NEW(Node)();
+	PAW_TEST_EXPECT_EQUAL(reused, nodes[node_count - 2]);
+	nodes[node_count - 2] = reused;
+	reused->value = node_count - 2;
+	for (S32 i = 0; i < node_count - 2; i += 2)
+	{
+		nodes[i] = PAW_NEW(Node)();
+		nodes[i]->value = static_cast<U64>(i);
+	}
+	PAW_TEST_EXPECT_EQUAL(slab.GetCommittedBytes(), committed_bytes);
+
+	for (S32 i = 0; i < node_count; i++)
+	{
+		all_intact &= nodes[i]->value == static_cast<U64>(i);
+	}
+	PAW_TEST_EXPECT(all_intact);
+
+	slab.FreeAll();
+	PAW_TEST_EXPECT_EQUAL(slab.GetLiveSlotCount(), 0);
+	PAW_TEST_EXPECT(slab.Alloc(sizeof(Node), alignof(Node)).ptr != nullptr);
+}
+
+PAW_TEST(SlabSlotsLargerThanAPage)
+{
+	SlabAllocator slab{KiloBytes(100), 16};
+	MemorySlice const first = slab.Alloc(KiloBytes(100), 16);
+	MemorySlice const second = slab.Alloc(KiloBytes(100), 16);
+	PAW_TEST_EXPECT_EQUAL(second.ptr, first.ptr + KiloBytes(100));
+	first.ptr[first.size_bytes - 1] = 1;
+	second.ptr[second.size_bytes - 1] = 1;
+	PAW_TEST_EXPECT(slab.GetCommittedBytes() >= KiloBytes(200));
+	PAW_TEST_EXPECT(slab.TryResize(first, KiloBytes(50)));
+	PAW_TEST_EXPECT_NOT(slab.TryResize(first, KiloBytes(101)));
+}
@@ -0,0 +1,88 @@
+#include <testing/testing.h>
+
+#include <core/string_id.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#define PAW_TEST_MODULE_NAME StringId
+
+static_assert(StringIdFromLiteral("").value == 0);
+static_assert(StringIdFromLiteral("Scene Color RT") == StringIdFromLiteral("Scene Color RT"));
+static_assert(!(StringIdFromLiteral("Scene Color RT") == StringIdFromLiteral("Scene Depth RT")));
+
+static bool StringEquals(StringView8 a, StringView8 b)
+{
+	return a.size_bytes == b.size_bytes && std::memcmp(a.ptr, b.ptr, a.size_bytes) == 0;
+}
+
+PAW_TEST(StringIdLiteralMatchesIntern)
+{
+	constexpr StringId compile_time_id = StringIdFromLiteral("Backbuffer");
+	PAW_TEST_EXPECT_EQUAL(StringIdIntern(PAW_STR("Backbuffer")).value, compile_time_id.value);
+	PAW_TEST_EXPECT_EQUAL(PAW_SID("Backbuffer").value, compile_time_id.value);
+	PAW_TEST_EXPECT_EQUAL(StringIdIntern(PAW_STR("")).value, U32(0));
+}
+
+PAW_TEST(StringIdReverseLookup)
+{
+	// PAW_SID registers the literal on first use, nothing else has to intern it
+	StringId const id = PAW_SID("StringIdReverseLookup pass");
+	PAW_TEST_EXPECT(StringEquals(StringIdGetString(id), PAW_STR("StringIdReverseLookup pass")));
+	PAW_TEST_EXPECT(StringEquals(StringIdGetString(StringId{}), PAW_STR("")));
+
+	char buffer[32];
+	S32 const size = std::snprintf(buffer, sizeof(buffer), "Runtime %d", 42);
+	StringId const runtime_id = StringIdIntern({.ptr = reinterpret_cast<Byte const*>(buffer), .size_bytes = static_cast<PtrSize>(size)});
+	buffer[0] = 'X';
+	PAW_TEST_EXPECT(StringEquals(StringIdGetString(runtime_id), PAW_STR("Runtime 42")));
+
+	PAW_TEST_EXPECT(StringEquals(StringIdGetString(StringIdFromLiteral("Never interned anywhere")), PAW_STR("<unknown StringId>")));
+}
+
+PAW_TEST(StringIdConcurrentIntern)
+{
+	static constexpr S32 thread_count = 4;
+	static constexpr S32 name_count = 2048;
+
+	S32 const count_before = StringIdGetCount();
+	StringId* const ids = new StringId[thread_count * name_count];
+
+	// Every thread interns the same names in a different order so they race on the same slots
+	std::thread threads[thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index] = std::thread([ids, thread_index]() {
+			for (S32 i = 0; i < name_count; i++)
+			{
+				S32 const name_index = (i * 7 + thread_index * 517) % name_count;
+				char name[32];
+				S32 const size = std::snprintf(name, sizeof(name), "Concurrent name %d", name_index);
+				ids[thread_index * name_count + name_index] = StringIdIntern({.ptr = reinterpret_cast<Byte const*>(name), .size_bytes = static_cast<PtrSize>(size)});
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	bool all_match = true;
+	for (S32 name_index = 0; name_index < name_count; name_index++)
+	{
+		char name[32];
+		S32 const size = std::snprintf(name, sizeof(name), "Concurrent name %d", name_index);
+		StringView8 const str = {.ptr = reinterpret_cast<Byte const*>(name), .size_bytes = static_cast<PtrSize>(size)};
+		for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+		{
+			all_match &= ids[thread_index * name_count + name_index] == ids[name_index];
+		}
+		all_match &= StringEquals(StringIdGetString(ids[name_index]), str);
+	}
+	delete[] ids;
+
+	PAW_TEST_EXPECT(all_match);
+	PAW_TEST_EXPECT_EQUAL(StringIdGetCount() - count_before, name_count);
+}
@@ -4,6 +4,9 @@
 
 #include <testing/testing.h>
 
+#include <atomic>
+#include <thread>
+
 struct alignas(16) Thing
 {
 };
@@ -12,22 +15,482 @@ PAW_TEST(Alloc)
 {
 	TLSFAllocator allocator{};
 	ScopedDefaultAllocator default_allocator{&allocator};
-	// allocator.Print();
 	allocator.Alloc(KiloBytes(64) - 17, 1);
 	Slice<Byte> bytes = PAW_NEW_SLICE(100, Byte);
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 	Slice<Byte> bytes2 = PAW_NEW_SLICE(100, Byte);
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 	Thing* thing = PAW_NEW(Thing)();
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 	PAW_DELETE_SLICE(bytes);
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 	PAW_DELETE_SLICE(bytes2);
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 	PAW_DELETE(thing);
-	allocator.Print();
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
 
 	Slice<Byte> bytes3 = PAW_NEW_SLICE(100, Byte);
 	(void)bytes3;
-	allocator.Print();
-}
\ No newline at end of file
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+}
+
+PAW_TEST(RandomAllocFree)
+{
+	TLSFAllocator allocator{};
+
+	static constexpr S32 slot_count = 512;
+	MemorySlice slots[slot_count]{};
+
+	// Random sizes and free order make sure splits and merges keep the physical block links intact
+	U64 random = 0x9E3779B97F4A7C15ull;
+	for (S32 i = 0; i < 20000; i++)
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		S32 const slot_index = static_cast<S32>((random >> 33) % slot_count);
+		MemorySlice& slot = slots[slot_index];
+		if (slot.ptr)
+		{
+			for (PtrSize byte_index = 0; byte_index < slot.size_bytes; byte_index++)
+			{
+				PAW_TEST_EXPECT_EQUAL(slot.ptr[byte_index], static_cast<Byte>(slot_index));
+			}
+			allocator.Free(slot);
+			slot = {};
+		}
+		else
+		{
+			PtrSize const size_bytes = 1 + (random >> 40) % 2048;
+			slot = allocator.Alloc(size_bytes, 16);
+			PAW_TEST_EXPECT(IsPointerAligned(slot.ptr, 16));
+			for (PtrSize byte_index = 0; byte_index < slot.size_bytes; byte_index++)
+			{
+				slot.ptr[byte_index] = static_cast<Byte>(slot_index);
+			}
+		}
+	}
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+}
+
+PAW_TEST(TryResize)
+{
+	TLSFAllocator allocator{};
+
+	MemorySlice const first = allocator.Alloc(100, 16);
+	MemorySlice const second = allocator.Alloc(100, 16);
+	MemorySlice const third = allocator.Alloc(100, 16);
+
+	// The next block is in use
+	PAW_TEST_EXPECT_NOT(allocator.TryResize(first, 400));
+
+	// Growing into the freed neighbour
+	allocator.Free(second);
+	PAW_TEST_EXPECT(allocator.TryResize(first, 200));
+	for (S32 i = 0; i < 200; i++)
+	{
+		first.ptr[i] = 1;
+	}
+
+	// Shrinking hands the tail back so the next allocation can use it
+	PAW_TEST_EXPECT(allocator.TryResize({first.ptr, 200}, 16));
+	MemorySlice const fourth = allocator.Alloc(100, 16);
+	PAW_TEST_EXPECT(fourth.ptr < third.ptr);
+
+	// The last block can grow into the free space left in the page
+	MemorySlice const last = allocator.Alloc(100, 16);
+	PAW_TEST_EXPECT(allocator.TryResize(last, KiloBytes(8)));
+
+	allocator.Free(first);
+	allocator.Free(third);
+	allocator.Free(fourth);
+	allocator.Free({last.ptr, KiloBytes(8)});
+	MemorySlice const whole = allocator.Alloc(KiloBytes(60), 16);
+	PAW_TEST_EXPECT(whole.ptr != nullptr);
+}
+
+PAW_TEST(MultiPageAllocations)
+{
+	TLSFAllocator allocator{};
+
+	// The first page fits this, once it's freed it's the trailing free block the next growth merges with
+	MemorySlice const small = allocator.Alloc(KiloBytes(40), 16);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(64));
+	allocator.Free(small);
+
+	MemorySlice const merged = allocator.Alloc(KiloBytes(100), 16);
+	PAW_TEST_EXPECT_EQUAL(merged.ptr, small.ptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), KiloBytes(128));
+
+	// Only the span that's needed gets committed, not a power of two
+	MemorySlice const large = allocator.Alloc(MegaBytes(3), 16);
+	PAW_TEST_EXPECT(large.ptr != nullptr);
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() <= KiloBytes(128) + MegaBytes(3) + KiloBytes(128));
+	large.ptr[0] = 1;
+	large.ptr[large.size_bytes - 1] = 1;
+
+	// Freed large blocks are reused without committing more
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+	allocator.Free(large);
+	MemorySlice const reused = allocator.Alloc(MegaBytes(2), 16);
+	PAW_TEST_EXPECT_EQUAL(reused.ptr, large.ptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+}
+
+PAW_TEST(MixedSmallAndLargeAllocFree)
+{
+	TLSFAllocator allocator{};
+
+	static constexpr S32 slot_count = 256;
+	MemorySlice slots[slot_count]{};
+
+	// Checks the first and last bytes and a sparse stride in between so multi-MB blocks stay cheap to verify
+	auto const for_each_checked_byte = [](MemorySlice slot, auto&& func) {
+		PtrSize const stride = slot.size_bytes > KiloBytes(4) ? KiloBytes(1) : 1;
+		for (PtrSize byte_index = 0; byte_index < slot.size_bytes; byte_index += stride)
+		{
+			func(slot.ptr[byte_index]);
+		}
+		func(slot.ptr[slot.size_bytes - 1]);
+	};
+
+	U64 random = 0x2545F4914F6CDD1Dull;
+	bool all_intact = true;
+	for (S32 i = 0; i < 10000; i++)
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		S32 const slot_index = static_cast<S32>((random >> 33) % slot_count);
+		MemorySlice& slot = slots[slot_index];
+		if (slot.ptr)
+		{
+			for_each_checked_byte(slot, [&](Byte& value) { all_intact &= value == static_cast<Byte>(slot_index); });
+			allocator.Free(slot);
+			slot = {};
+		}
+		else
+		{
+			bool const is_large = (random >> 20) % 16 == 0;
+			PtrSize const size_bytes = is_large ? MegaBytes(1) + (random >> 40) % MegaBytes(4) : 1 + (random >> 40) % 2048;
+			slot = allocator.Alloc(size_bytes, 16);
+			PAW_TEST_EXPECT(IsPointerAligned(slot.ptr, 16));
+			for_each_checked_byte(slot, [&](Byte& value) { value = static_cast<Byte>(slot_index); });
+		}
+	}
+	PAW_TEST_EXPECT(all_intact);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	for (MemorySlice const& slot : slots)
+	{
+		if (slot.ptr)
+		{
+			allocator.Free(slot);
+		}
+	}
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	// Everything merged back into one block, so the whole heap can be handed out again in one go
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+	PAW_TEST_EXPECT(allocator.Alloc(committed_bytes / 2, 16).ptr != nullptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+}
+
+PAW_TEST(TrailingPageRelease)
+{
+	TLSFAllocator allocator{};
+	TLSFReleasePolicy const policy{};
+
+	MemorySlice const small = allocator.Alloc(KiloBytes(1), 16);
+	MemorySlice const large = allocator.Alloc(policy.trailing_release_threshold_bytes * 2, 16);
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() > policy.trailing_release_threshold_bytes * 2);
+	large.ptr[large.size_bytes - 1] = 1;
+
+	// Only trailing_keep_bytes and the page the free block's header starts in stay committed
+	allocator.Free(large);
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() >= policy.trailing_keep_bytes);
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() <= policy.trailing_keep_bytes + KiloBytes(128));
+
+	// Below the release threshold the tail stays committed for the next allocation
+	MemorySlice const medium = allocator.Alloc(policy.trailing_release_threshold_bytes / 2, 16);
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+	allocator.Free(medium);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+
+	allocator.SetReleasePolicy({.trailing_release_threshold_bytes = 0});
+	MemorySlice const kept = allocator.Alloc(policy.trailing_release_threshold_bytes * 2, 16);
+	PtrSize const kept_committed_bytes = allocator.GetCommittedBytes();
+	allocator.Free(kept);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), kept_committed_bytes);
+
+	allocator.Free(small);
+}
+
+PAW_TEST(InteriorPagePurge)
+{
+	TLSFAllocator allocator{};
+	allocator.SetReleasePolicy({.interior_purge_threshold_bytes = MegaBytes(1)});
+
+	MemorySlice const interior = allocator.Alloc(MegaBytes(4), 16);
+	MemorySlice const fence = allocator.Alloc(KiloBytes(1), 16);
+	for (PtrSize i = 0; i < interior.size_bytes; i += KiloBytes(4))
+	{
+		interior.ptr[i] = 0xAB;
+	}
+
+	// Purged pages stay committed and the block is handed out again as usual
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+	allocator.Free(interior);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+
+	MemorySlice const reused = allocator.Alloc(MegaBytes(2), 16);
+	PAW_TEST_EXPECT_EQUAL(reused.ptr, interior.ptr);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetCommittedBytes(), committed_bytes);
+	bool all_intact = true;
+	for (PtrSize i = 0; i < reused.size_bytes; i += KiloBytes(4))
+	{
+		reused.ptr[i] = 0xCD;
+	}
+	for (PtrSize i = 0; i < reused.size_bytes; i += KiloBytes(4))
+	{
+		all_intact &= reused.ptr[i] == 0xCD;
+	}
+	PAW_TEST_EXPECT(all_intact);
+
+	allocator.Free(reused);
+	allocator.Free(fence);
+}
+
+PAW_TEST(ReleasePolicyRandomAllocFree)
+{
+	TLSFAllocator allocator{};
+	// Low thresholds so nearly every free releases or purges something, none of it may touch a live block or a header
+	allocator.SetReleasePolicy({
+		.trailing_release_threshold_bytes = KiloBytes(256),
+		.trailing_keep_bytes = KiloBytes(64),
+		.interior_purge_threshold_bytes = KiloBytes(128),
+	});
+
+	static constexpr S32 slot_count = 128;
+	MemorySlice slots[slot_count]{};
+
+	U64 random = 0x6A09E667F3BCC908ull;
+	bool all_intact = true;
+	for (S32 i = 0; i < 10000; i++)
+	{
+		random = random * 6364136223846793005ull + 1442695040888963407ull;
+		S32 const slot_index = static_cast<S32>((random >> 33) % slot_count);
+		MemorySlice& slot = slots[slot_index];
+		if (slot.ptr)
+		{
+			for (PtrSize byte_index = 0; byte_index < slot.size_bytes; byte_index += 512)
+			{
+				all_intact &= slot.ptr[byte_index] == static_cast<Byte>(slot_index);
+			}
+			all_intact &= slot.ptr[slot.size_bytes - 1] == static_cast<Byte>(slot_index);
+			allocator.Free(slot);
+			slot = {};
+		}
+		else
+		{
+			bool const is_large = (random >> 20) % 8 == 0;
+			PtrSize const size_bytes = is_large ? KiloBytes(64) + (random >> 40) % MegaBytes(1) : 1 + (random >> 40) % 4096;
+			slot = allocator.Alloc(size_bytes, 16);
+			PAW_TEST_EXPECT(slot.ptr != nullptr);
+			for (PtrSize byte_index = 0; byte_index < slot.size_bytes; byte_index += 512)
+			{
+				slot.ptr[byte_index] = static_cast<Byte>(slot_index);
+			}
+			slot.ptr[slot.size_bytes - 1] = static_cast<Byte>(slot_index);
+		}
+	}
+	PAW_TEST_EXPECT(all_intact);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	for (MemorySlice const& slot : slots)
+	{
+		if (slot.ptr)
+		{
+			allocator.Free(slot);
+		}
+	}
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() <= KiloBytes(64) + KiloBytes(128));
+}
+
+PAW_TEST(Stats)
+{
+	TLSFAllocator allocator{};
+	TLSFStats const empty_stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(empty_stats.free_bytes + empty_stats.used_bytes, PtrSize(0));
+	PAW_TEST_EXPECT_EQUAL(empty_stats.external_fragmentation, 0.0f);
+
+	// 1 KiB blocks, three quarters of the first page
+	static constexpr S32 allocation_count = 48;
+	MemorySlice allocations[allocation_count];
+	for (MemorySlice& allocation : allocations)
+	{
+		allocation = allocator.Alloc(1000, 16);
+	}
+
+	TLSFStats const full_stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(full_stats.used_block_count, allocation_count);
+	PAW_TEST_EXPECT_EQUAL(full_stats.free_bytes + full_stats.used_bytes, allocator.GetCommittedBytes());
+	PAW_TEST_EXPECT(full_stats.used_bytes >= allocation_count * PtrSize(1000));
+	// Whatever is left of the last page is the only free block
+	PAW_TEST_EXPECT_EQUAL(full_stats.free_block_count, 1);
+	PAW_TEST_EXPECT_EQUAL(full_stats.largest_free_block_bytes, full_stats.free_bytes);
+	PAW_TEST_EXPECT_EQUAL(full_stats.external_fragmentation, 0.0f);
+
+	// Every other block freed leaves holes that can't merge, so most free memory isn't in the largest block
+	for (S32 i = 0; i < allocation_count; i += 2)
+	{
+		allocator.Free(allocations[i]);
+	}
+	TLSFStats const holes_stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(holes_stats.used_block_count, allocation_count / 2);
+	PAW_TEST_EXPECT_EQUAL(holes_stats.free_block_count, allocation_count / 2 + 1);
+	PAW_TEST_EXPECT(holes_stats.external_fragmentation > 0.5f);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	S32 bin_block_count = 0;
+	Slice<U32 const> const bin_block_counts = allocator.GetFreeBinBlockCounts();
+	for (S32 i = 0; i < bin_block_counts.count; i++)
+	{
+		bin_block_count += static_cast<S32>(bin_block_counts[i]);
+	}
+	S32 top_level_block_count = 0;
+	for (S32 count : holes_stats.top_level_free_block_counts)
+	{
+		top_level_block_count += count;
+	}
+	PAW_TEST_EXPECT_EQUAL(bin_block_count, holes_stats.free_block_count);
+	PAW_TEST_EXPECT_EQUAL(top_level_block_count, holes_stats.free_block_count);
+
+	for (S32 i = 1; i < allocation_count; i += 2)
+	{
+		allocator.Free(allocations[i]);
+	}
+	TLSFStats const freed_stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(freed_stats.used_block_count, 0);
+	PAW_TEST_EXPECT_EQUAL(freed_stats.used_bytes, PtrSize(0));
+	PAW_TEST_EXPECT_EQUAL(freed_stats.free_block_count, 1);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+}
+
+PAW_TEST(VerifyHeapCatchesCorruption)
+{
+	TLSFAllocator allocator{};
+	MemorySlice const first = allocator.Alloc(100, 16);
+	MemorySlice const second = allocator.Alloc(100, 16);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	// Writing in front of the allocation lands in the second block's header
+	U64 const saved = reinterpret_cast<U64*>(second.ptr)[-2];
+	reinterpret_cast<U64*>(second.ptr)[-2] = 3;
+	PAW_TEST_EXPECT_NOT(allocator.VerifyHeap());
+	reinterpret_cast<U64*>(second.ptr)[-2] = saved;
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	allocator.Free(first);
+	allocator.Free(second);
+}
+
+PAW_TEST(ThreadCachingCrossThreadFree)
+{
+	static constexpr S32 thread_count = 4;
+	static constexpr S32 allocation_count = 4096;
+
+	ThreadCachingTLSFAllocator allocator{};
+	MemorySlice* const allocations = new MemorySlice[thread_count * allocation_count];
+	std::atomic<S32> allocated_thread_count = 0;
+	std::atomic<bool> all_intact = true;
+
+	std::thread threads[thread_count];
+	for (S32 thread_index = 0; thread_index < thread_count; thread_index++)
+	{
+		threads[thread_index] = std::thread([&, thread_index]() {
+			MemorySlice* const own = allocations + thread_index * allocation_count;
+			for (S32 i = 0; i < allocation_count; i++)
+			{
+				// Mostly cached size classes with some bigger and over-aligned blocks that go to the heap directly
+				PtrSize const size_bytes = 1 + static_cast<PtrSize>((i * 37 + thread_index) % 320);
+				PtrSize const alignment = i % 11 == 0 ? 64 : 16;
+				own[i] = AllocMem(size_bytes, alignment, &allocator, SrcLoc());
+				std::memset(own[i].ptr, thread_index + 1, own[i].size_bytes);
+			}
+
+			allocated_thread_count.fetch_add(1);
+			while (allocated_thread_count.load() < thread_count)
+			{
+				std::this_thread::yield();
+			}
+
+			// Free the neighbour's blocks, FreeMem has to find the caching allocator from the pointer alone
+			S32 const neighbour_index = (thread_index + 1) % thread_count;
+			MemorySlice* const neighbour = allocations + neighbour_index * allocation_count;
+			for (S32 i = 0; i < allocation_count; i++)
+			{
+				bool intact = true;
+				for (PtrSize byte_index = 0; byte_index < neighbour[i].size_bytes; byte_index++)
+				{
+					intact &= neighbour[i].ptr[byte_index] == static_cast<Byte>(neighbour_index + 1);
+				}
+				if (!intact)
+				{
+					all_intact = false;
+				}
+				FreeMem(neighbour[i], nullptr, SrcLoc());
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	delete[] allocations;
+
+	PAW_TEST_EXPECT(all_intact.load());
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	// Blocks parked in the finished threads' magazines stay there until a trim, the stats don't trim
+	TLSFStats const cached_stats = allocator.GetStats();
+	PAW_TEST_EXPECT(cached_stats.cached_bytes > 0);
+	PAW_TEST_EXPECT(cached_stats.used_block_count > 0);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetStats().cached_bytes, cached_stats.cached_bytes);
+
+	allocator.TrimCaches();
+	TLSFStats const trimmed_stats = allocator.GetStats();
+	PAW_TEST_EXPECT_EQUAL(trimmed_stats.cached_bytes, PtrSize(0));
+	PAW_TEST_EXPECT_EQUAL(trimmed_stats.used_block_count, 0);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+
+	MemorySlice const reused = allocator.Alloc(64, 16);
+	PAW_TEST_EXPECT(reused.ptr != nullptr);
+	allocator.Free(reused);
+}
+
+PAW_TEST(ThreadCachingTrimReleasesTail)
+{
+	ThreadCachingTLSFAllocator allocator{};
+	allocator.SetReleasePolicy({.trailing_release_threshold_bytes = KiloBytes(256), .trailing_keep_bytes = 0});
+
+	// The last blocks freed stay in the exited thread's magazine, right at the end of the heap
+	std::thread thread([&allocator]() {
+		static constexpr S32 allocation_count = 16384;
+		MemorySlice* const allocations = new MemorySlice[allocation_count];
+		for (S32 i = 0; i < allocation_count; i++)
+		{
+			allocations[i] = allocator.Alloc(64, 16);
+		}
+		for (S32 i = 0; i < allocation_count; i++)
+		{
+			allocator.Free(allocations[i]);
+		}
+		delete[] allocations;
+	});
+	thread.join();
+	PtrSize const committed_bytes = allocator.GetCommittedBytes();
+
+	allocator.TrimCaches();
+	PAW_TEST_EXPECT(allocator.GetCommittedBytes() < committed_bytes);
+	PAW_TEST_EXPECT_EQUAL(allocator.GetStats().used_block_count, 0);
+	PAW_TEST_EXPECT(allocator.VerifyHeap());
+}
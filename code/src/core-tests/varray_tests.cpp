@@ -0,0 +1,123 @@
+#include <testing/testing.h>
+
+#include <core/tlsf.h>
+#include <core/varray.h>
+
+#define PAW_TEST_MODULE_NAME VArray
+
+struct VArrayItem
+{
+	S32 value = 0;
+	F32 payload[7]{};
+};
+
+PAW_TEST(VArrayPushKeepsPointers)
+{
+	TLSFAllocator allocator{};
+	VArray<VArrayItem> array{&allocator};
+
+	VArrayItem* const first = &array.PushBack(VArrayItem{.value = 0});
+	S32 const first_capacity = array.GetCapacity();
+
+	// Well past the first commit step, the items must never move
+	static constexpr S32 item_count = 100000;
+	VArrayItem* last_in_first_step = nullptr;
+	for (S32 i = 1; i < item_count; i++)
+	{
+		VArrayItem& item = array.PushBack(VArrayItem{.value = i});
+		if (i == first_capacity - 1)
+		{
+			last_in_first_step = &item;
+		}
+	}
+
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), item_count);
+	PAW_TEST_EXPECT(array.GetCapacity() >= item_count);
+	PAW_TEST_EXPECT(&array[0] == first);
+	PAW_TEST_EXPECT(&array[first_capacity - 1] == last_in_first_step);
+
+	bool all_match = true;
+	S32 index = 0;
+	for (VArrayItem const& item : array)
+	{
+		all_match &= item.value == index++;
+	}
+	PAW_TEST_EXPECT(all_match);
+	PAW_TEST_EXPECT_EQUAL(array.GetItems().count, item_count);
+}
+
+PAW_TEST(VArrayPopClearRelease)
+{
+	TLSFAllocator allocator{};
+	VArray<VArrayItem> array{&allocator};
+
+	array.Reserve(1000);
+	S32 const reserved_capacity = array.GetCapacity();
+	PAW_TEST_EXPECT(reserved_capacity >= 1000);
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), 0);
+
+	for (S32 i = 0; i < 10; i++)
+	{
+		array.PushBack(VArrayItem{.value = i});
+	}
+	array.PopBack();
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), 9);
+	PAW_TEST_EXPECT_EQUAL(array[8].value, 8);
+
+	// Clear keeps the pages, pushing again reuses the same memory
+	VArrayItem* const first = &array[0];
+	array.Clear();
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), 0);
+	PAW_TEST_EXPECT_EQUAL(array.GetCapacity(), reserved_capacity);
+	PAW_TEST_EXPECT(&array.PushBack() == first);
+
+	array.Release();
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), 0);
+	PAW_TEST_EXPECT_EQUAL(array.GetCapacity(), 0);
+	PAW_TEST_EXPECT_EQUAL(array.GetArena()->GetCommittedBytes(), PtrSize(0));
+
+	array.PushBack(VArrayItem{.value = 42});
+	PAW_TEST_EXPECT_EQUAL(array[0].value, 42);
+}
+
+PAW_TEST(VArrayCommitLimit)
+{
+	TLSFAllocator allocator{};
+	VArray<VArrayItem> array{&allocator};
+	array.GetArena()->SetCommitLimit(KiloBytes(256));
+
+	// Committing is lazy, only what has been pushed so far counts against the limit
+	static constexpr S32 item_count = 5000;
+	for (S32 i = 0; i < item_count; i++)
+	{
+		array.PushBack(VArrayItem{.value = i});
+	}
+	PAW_TEST_EXPECT(array.GetArena()->GetCommittedBytes() <= KiloBytes(256));
+	PAW_TEST_EXPECT(array.GetArena()->GetCommittedBytes() >= sizeof(VArrayItem) * item_count);
+}
+
+PAW_TEST(VArrayCommitLimitFailure)
+{
+	TLSFAllocator allocator{};
+	VArray<VArrayItem> array{&allocator};
+	array.GetArena()->SetCommitLimit(VArray<VArrayItem>::growth_step_bytes);
+
+	// Fill the first step, the next push needs pages past the limit
+	S32 pushed_count = 0;
+	while (array.TryPushBack(VArrayItem{.value = pushed_count}) != nullptr)
+	{
+		pushed_count++;
+	}
+
+	S32 const capacity = array.GetCapacity();
+	PAW_TEST_EXPECT_EQUAL(pushed_count, capacity);
+	PAW_TEST_EXPECT_EQUAL(array.GetCount(), capacity);
+	PAW_TEST_EXPECT(!array.Reserve(capacity + 1));
+	PAW_TEST_EXPECT_EQUAL(array.GetCapacity(), capacity);
+	PAW_TEST_EXPECT_EQUAL(array[capacity - 1].value, capacity - 1);
+
+	// Raising the limit lets the same array carry on
+	array.GetArena()->SetCommitLimit(0);
+	PAW_TEST_EXPECT(array.TryPushBack(VArrayItem{.value = capacity}) != nullptr);
+	PAW_TEST_EXPECT_EQUAL(array[capacity].value, capacity);
+}
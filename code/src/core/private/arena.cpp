@@ -2,6 +2,10 @@
 
 #include <core/memory.h>
 
+#include "memory_tracking_internal.h"
+
+#include <thread>
+
 FixedSizeArenaAllocator::FixedSizeArenaAllocator(Byte* memory, PtrSize size_Bytes)
 	: memory(memory)
 	, total_size_Bytes(size_Bytes)
@@ -34,10 +38,38 @@ MemorySlice FixedSizeArenaAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment
 void FixedSizeArenaAllocator::Free(MemorySlice in_memory)
 {
 	PAW_ASSERT(in_memory.ptr >= memory && in_memory.ptr + in_memory.size_bytes <= memory + total_size_Bytes, "Memory is not in the memory range owned by this allocator, did you pass the right one in?");
+
+	if (in_memory.ptr + in_memory.size_bytes == memory + head_Bytes)
+	{
+		head_Bytes = static_cast<PtrSize>(in_memory.ptr - memory);
+	}
+}
+
+bool FixedSizeArenaAllocator::TryResize(MemorySlice in_memory, PtrSize new_size_bytes)
+{
+	bool const is_last_allocation = in_memory.ptr + in_memory.size_bytes == memory + head_Bytes;
+	if (!is_last_allocation)
+	{
+		return new_size_bytes <= in_memory.size_bytes;
+	}
+
+	PtrSize const new_head_Bytes = static_cast<PtrSize>(in_memory.ptr - memory) + new_size_bytes;
+	if (new_head_Bytes > total_size_Bytes)
+	{
+		return false;
+	}
+
+	head_Bytes = new_head_Bytes;
+	return true;
 }
 
 void FixedSizeArenaAllocator::FreeAll()
 {
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordReleaseRange({memory, head_Bytes}, this);
+	}
+
 	head_Bytes = 0;
 }
 
@@ -46,10 +78,16 @@ ArenaMarker_t FixedSizeArenaAllocator::GetMarker() const
 	return {head_Bytes};
 }
 
-void FixedSizeArenaAllocator::FreeToMarker(ArenaMarker_t marker)
+void FixedSizeArenaAllocator::FreeToMarker(ArenaMarker_t marker, bool /*release_pages*/)
 {
 	PAW_ASSERT(marker.head <= total_size_Bytes, "Arena marker is not in a valid range");
 	PAW_ASSERT(marker.head <= head_Bytes, "Arena marker is not less than the head");
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordReleaseRange({memory + marker.head, head_Bytes - marker.head}, this);
+	}
+
 	head_Bytes = marker.head;
 }
 
@@ -215,7 +253,9 @@ PtrSize InstrusiveArenaAllocator::GetFreeBytesInPage() const
 }
 #endif
 
-PagedArenaAllocator::PagedArenaAllocator()
+PagedArenaAllocator::PagedArenaAllocator(PageConfig page_config)
+	: IAllocator(page_config)
+	, next_block_size_Bytes(GetPageSize())
 {
 }
 
@@ -225,94 +265,130 @@ PagedArenaAllocator::~PagedArenaAllocator()
 
 MemorySlice PagedArenaAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
 {
-	bool space_available = false;
-
-	Byte* start_ptr = nullptr;
-	PtrSize alignment_offset = 0;
-
-	if (GetPageCount() > 0)
+	if (current_block)
 	{
-		Page& current_page = GetCurrentPage();
-		PtrSize const remaining = current_page.memory.size_bytes - current_page.used;
-		start_ptr = current_page.memory.ptr + current_page.used;
-		alignment_offset = CalcAlignmentOffset(start_ptr, alignment);
+		MemorySlice const result = AllocFromBlock(*current_block, size_Bytes, alignment);
+		if (result.ptr)
+		{
+			return result;
+		}
+	}
 
-		space_available = size_Bytes + alignment_offset <= remaining;
+	PtrSize const worst_case_size_Bytes = sizeof(Block) + alignment - 1 + size_Bytes;
+	if (worst_case_size_Bytes > next_block_size_Bytes / 4)
+	{
+		Block* const span = AddBlock(worst_case_size_Bytes, true);
+		return span ? AllocFromBlock(*span, size_Bytes, alignment) : MemorySlice{};
 	}
 
-	if (!space_available || GetPageCount() == 0)
+	Block* const block = AddBlock(next_block_size_Bytes, false);
+	if (!block)
 	{
-		Byte* const new_page_ptr = GetBaseAddress() + CalcMemorySizeBytes();
-		PAW_ASSERT(GetPageCount() < max_page_count - 1, "Not enough pages left in the arena");
-		Page& new_page = pages[GetPageCount()];
-		AllocPages(1);
-		new_page.used = 0;
-		new_page.memory = {new_page_ptr, GetPageSize()};
-		PAW_ASSERT(size_Bytes <= new_page.memory.size_bytes, "Impossible to fit allocation inside page");
+		return {};
+	}
 
-		start_ptr = new_page.memory.ptr;
-		alignment_offset = CalcAlignmentOffset(start_ptr, alignment);
+	current_block = block;
+	if (next_block_size_Bytes < max_block_size_bytes)
+	{
+		next_block_size_Bytes *= 2;
 	}
 
-	PAW_ASSERT(start_ptr, "No memory to write to");
+	return AllocFromBlock(*block, size_Bytes, alignment);
+}
 
-	Page& current_page = GetCurrentPage();
-	current_page.used += size_Bytes + alignment_offset;
+void PagedArenaAllocator::Free(MemorySlice memory)
+{
+	// A dedicated span only ever holds the one allocation it was made for
+	if (last_block && last_block->is_dedicated && memory.ptr + memory.size_bytes == reinterpret_cast<Byte*>(last_block) + last_block->used)
+	{
+		PopLastBlock();
+		return;
+	}
 
-	return {start_ptr + alignment_offset, size_Bytes};
+	// The alignment padding in front of the allocation isn't known here, so it stays used until the next rewind
+	Byte* const block_ptr = reinterpret_cast<Byte*>(current_block);
+	if (current_block && memory.ptr + memory.size_bytes == block_ptr + current_block->used)
+	{
+		current_block->used = static_cast<PtrSize>(memory.ptr - block_ptr);
+	}
 }
 
-void PagedArenaAllocator::Free(MemorySlice /*memory*/)
+bool PagedArenaAllocator::TryResize(MemorySlice memory, PtrSize new_size_bytes)
 {
-	// #TODO: I could keep track of the last allocation here (unaligned and unaligned offset)
-	// And if it matches, I could reset to before
+	if (!current_block)
+	{
+		return new_size_bytes <= memory.size_bytes;
+	}
+
+	Byte* const block_ptr = reinterpret_cast<Byte*>(current_block);
+	bool const is_last_allocation = memory.ptr + memory.size_bytes == block_ptr + current_block->used;
+	if (!is_last_allocation)
+	{
+		return new_size_bytes <= memory.size_bytes;
+	}
+
+	PtrSize const new_used = static_cast<PtrSize>(memory.ptr - block_ptr) + new_size_bytes;
+	if (new_used > current_block->size_bytes)
+	{
+		return false;
+	}
+
+	current_block->used = new_used;
+	return true;
 }
 
 void PagedArenaAllocator::FreeAll()
 {
-	for (S32 i = 0; i < GetPageCount(); i++)
-	{
-		Page& page = pages[i];
-		page.memory.ptr = nullptr;
-		page.memory.size_bytes = 0;
-	}
+	last_block = nullptr;
+	current_block = nullptr;
+	next_block_size_Bytes = GetPageSize();
 	FreeAllPages();
 }
 
-void PagedArenaAllocator::FreeToMarker(ArenaMarker_t marker)
+void PagedArenaAllocator::FreeToMarker(ArenaMarker_t marker, bool /*release_pages*/)
 {
-	if (marker.head == 0)
+	if (marker.committed_end == 0)
 	{
 		FreeAll();
 		return;
 	}
 
-	for (S32 i = GetPageCount() - 1; i >= 0; i--)
+	while (last_block && reinterpret_cast<PtrSize>(last_block) >= marker.committed_end)
 	{
-		Page& page = pages[i];
-		PtrSize const page_start = reinterpret_cast<PtrSize>(page.memory.ptr);
-		PtrSize const page_end = page_start + page.used;
-		if (marker.head >= page_start && marker.head <= page_end)
+		PopLastBlock();
+	}
+
+	// Whatever block the head was in when the marker was taken is still around, everything after it is gone
+	current_block = nullptr;
+	for (Block* block = last_block; block && marker.head != 0; block = block->prev_block)
+	{
+		PtrSize const block_start = reinterpret_cast<PtrSize>(block);
+		if (!block->is_dedicated && marker.head >= block_start && marker.head <= block_start + block->used)
 		{
-			page.used = marker.head - page_start;
-			return;
+			if (IsMemoryTrackingRunning())
+			{
+				MemoryTrackingRecordReleaseRange({reinterpret_cast<Byte*>(marker.head), block_start + block->used - marker.head}, this);
+			}
+
+			block->used = marker.head - block_start;
+			current_block = block;
+			break;
 		}
-
-		FreePages(1);
 	}
 
-	// Marker was not in the range of any page
-	PAW_UNREACHABLE;
+	PAW_ASSERT(current_block || marker.head == 0, "Marker was not in the range of any block");
 }
 
 ArenaMarker_t PagedArenaAllocator::GetMarker() const
 {
-	if (GetPageCount() > 0)
+	if (!last_block)
 	{
-		Page const& page = GetCurrentPage();
-		return ArenaMarker_t{reinterpret_cast<PtrSize>(page.memory.ptr + page.used)};
+		return {};
 	}
-	return ArenaMarker_t{0};
+
+	PtrSize const head = current_block ? reinterpret_cast<PtrSize>(current_block) + current_block->used : 0;
+	PtrSize const committed_end = reinterpret_cast<PtrSize>(last_block) + last_block->size_bytes;
+	return {head, committed_end};
 }
 
 S32 PagedArenaAllocator::GetPageCount() const
@@ -320,29 +396,77 @@ S32 PagedArenaAllocator::GetPageCount() const
 	return static_cast<S32>(IAllocator::GetPageCount());
 }
 
+S32 PagedArenaAllocator::GetBlockCount() const
+{
+	S32 result = 0;
+	for (Block* block = last_block; block; block = block->prev_block)
+	{
+		result++;
+	}
+	return result;
+}
+
 PtrSize PagedArenaAllocator::GetFreeBytesInPage() const
 {
-	if (GetPageCount() > 0)
+	if (current_block)
 	{
-		Page const& page = GetCurrentPage();
-		return page.memory.size_bytes - page.used;
+		return current_block->size_bytes - current_block->used;
 	}
 	return 0;
 }
 
-PagedArenaAllocator::Page& PagedArenaAllocator::GetCurrentPage()
+PagedArenaAllocator::Block* PagedArenaAllocator::AddBlock(PtrSize size_bytes, bool is_dedicated)
+{
+	Byte* const block_ptr = GetBaseAddress() + CalcMemorySizeBytes();
+	PtrSize const page_count = CalcPageCountFromSize(size_bytes);
+	if (!AllocPages(page_count))
+	{
+		return nullptr;
+	}
+
+	Block* const block = reinterpret_cast<Block*>(block_ptr);
+	block->prev_block = last_block;
+	block->used = sizeof(Block);
+	block->size_bytes = page_count * GetPageSize();
+	block->is_dedicated = is_dedicated;
+	last_block = block;
+
+	return block;
+}
+
+void PagedArenaAllocator::PopLastBlock()
 {
-	PAW_ASSERT(GetPageCount() > 0, "This arena has no pages");
-	return pages[GetPageCount() - 1];
+	Block* const block = last_block;
+	if (block == current_block)
+	{
+		current_block = nullptr;
+	}
+
+	// The next block takes the place of this one, so it starts over at the same size
+	if (!block->is_dedicated)
+	{
+		next_block_size_Bytes = block->size_bytes;
+	}
+
+	last_block = block->prev_block;
+	FreePages(CalcPageCountFromSize(block->size_bytes));
 }
 
-PagedArenaAllocator::Page const& PagedArenaAllocator::GetCurrentPage() const
+MemorySlice PagedArenaAllocator::AllocFromBlock(Block& block, PtrSize size_Bytes, PtrSize alignment)
 {
-	PAW_ASSERT(GetPageCount() > 0, "This arena has no pages");
-	return pages[GetPageCount() - 1];
+	Byte* const start_ptr = reinterpret_cast<Byte*>(&block) + block.used;
+	PtrSize const alignment_offset = CalcAlignmentOffset(start_ptr, alignment);
+	if (block.used + alignment_offset + size_Bytes > block.size_bytes)
+	{
+		return {};
+	}
+
+	block.used += alignment_offset + size_Bytes;
+	return {start_ptr + alignment_offset, size_Bytes};
 }
 
-ArenaAllocator::ArenaAllocator()
+ArenaAllocator::ArenaAllocator(PageConfig page_config)
+	: IAllocator(page_config)
 {
 }
 
@@ -360,7 +484,10 @@ MemorySlice ArenaAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
 	{
 		PtrSize const overflow_Bytes = total_size_Bytes - remaining;
 		PtrSize const new_page_count = CalcPageCountFromSize(overflow_Bytes);
-		AllocPages(new_page_count);
+		if (!AllocPages(new_page_count))
+		{
+			return {};
+		}
 	}
 
 	used_Bytes += total_size_Bytes;
@@ -368,8 +495,31 @@ MemorySlice ArenaAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
 	return {start_ptr + alignment_offset, size_Bytes};
 }
 
-void ArenaAllocator::Free(MemorySlice /*memory*/)
+void ArenaAllocator::Free(MemorySlice memory)
 {
+	if (memory.ptr + memory.size_bytes == GetBaseAddress() + used_Bytes)
+	{
+		used_Bytes = static_cast<PtrSize>(memory.ptr - GetBaseAddress());
+	}
+}
+
+bool ArenaAllocator::TryResize(MemorySlice memory, PtrSize new_size_bytes)
+{
+	bool const is_last_allocation = memory.ptr + memory.size_bytes == GetBaseAddress() + used_Bytes;
+	if (!is_last_allocation)
+	{
+		return new_size_bytes <= memory.size_bytes;
+	}
+
+	PtrSize const new_used_Bytes = static_cast<PtrSize>(memory.ptr - GetBaseAddress()) + new_size_bytes;
+	PtrSize const committed_Bytes = CalcMemorySizeBytes();
+	if (new_used_Bytes > committed_Bytes && !AllocPages(CalcPageCountFromSize(new_used_Bytes - committed_Bytes)))
+	{
+		return false;
+	}
+
+	used_Bytes = new_used_Bytes;
+	return true;
 }
 
 void ArenaAllocator::FreeAll()
@@ -378,9 +528,23 @@ void ArenaAllocator::FreeAll()
 	used_Bytes = 0;
 }
 
-void ArenaAllocator::FreeToMarker(ArenaMarker_t marker)
+void ArenaAllocator::FreeToMarker(ArenaMarker_t marker, bool release_pages)
 {
-	PAW_UNUSED_ARG(marker);
+	PAW_ASSERT(marker.head <= used_Bytes, "Arena marker is not less than the head");
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordReleaseRange({GetBaseAddress() + marker.head, used_Bytes - marker.head}, this);
+	}
+
+	used_Bytes = marker.head;
+
+	PtrSize const page_count = IAllocator::GetPageCount();
+	PtrSize const used_page_count = CalcPageCountFromSize(used_Bytes);
+	if (release_pages && page_count > used_page_count)
+	{
+		FreePages(page_count - used_page_count);
+	}
 }
 
 ArenaMarker_t ArenaAllocator::GetMarker() const
@@ -392,3 +556,97 @@ S32 ArenaAllocator::GetPageCount() const
 {
 	return static_cast<S32>(IAllocator::GetPageCount());
 }
+
+ConcurrentArenaAllocator::ConcurrentArenaAllocator(PageConfig page_config)
+	: IAllocator(page_config)
+{
+}
+
+ConcurrentArenaAllocator::~ConcurrentArenaAllocator()
+{
+}
+
+MemorySlice ConcurrentArenaAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
+{
+	// Sizes are rounded up so the head always stays base aligned, only bigger alignments need room for padding. That
+	// way the head only has to move once without reserving for the worst case on every allocation.
+	PtrSize const reserve_size_Bytes = AlignSizeForward(size_Bytes, base_alignment) + (alignment > base_alignment ? alignment - base_alignment : 0);
+	PtrSize const start_Bytes = head_Bytes.fetch_add(reserve_size_Bytes, std::memory_order_relaxed);
+	Byte* const start_ptr = GetBaseAddress() + start_Bytes;
+	PtrSize const alignment_offset = alignment > base_alignment ? CalcAlignmentOffset(start_ptr, alignment) : 0;
+	PtrSize const end_Bytes = start_Bytes + alignment_offset + size_Bytes;
+
+	if (end_Bytes > committed_Bytes.load(std::memory_order_acquire) && !CommitUpTo(end_Bytes))
+	{
+		// Give the space back if nothing was appended after it, otherwise GetUsedBytes clamps to what's committed
+		PtrSize expected_head_Bytes = start_Bytes + reserve_size_Bytes;
+		head_Bytes.compare_exchange_strong(expected_head_Bytes, start_Bytes, std::memory_order_relaxed);
+		return {};
+	}
+
+	return {start_ptr + alignment_offset, size_Bytes};
+}
+
+void ConcurrentArenaAllocator::Free(MemorySlice /*memory*/)
+{
+}
+
+void ConcurrentArenaAllocator::FreeAll()
+{
+	PAW_ASSERT(!committing.load(std::memory_order_relaxed), "The arena is being reset while another thread is allocating from it");
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordReleaseRange({GetBaseAddress(), GetUsedBytes()}, this);
+	}
+
+	FreeAllPages();
+	head_Bytes.store(0, std::memory_order_relaxed);
+	committed_Bytes.store(0, std::memory_order_relaxed);
+}
+
+PtrSize ConcurrentArenaAllocator::GetUsedBytes() const
+{
+	// The head can run past the committed memory when an allocation failed to commit
+	PtrSize const used_Bytes = head_Bytes.load(std::memory_order_relaxed);
+	PtrSize const committed_size_Bytes = committed_Bytes.load(std::memory_order_relaxed);
+	return used_Bytes < committed_size_Bytes ? used_Bytes : committed_size_Bytes;
+}
+
+bool ConcurrentArenaAllocator::CommitUpTo(PtrSize end_Bytes)
+{
+	while (committed_Bytes.load(std::memory_order_acquire) < end_Bytes)
+	{
+		if (committing.exchange(true, std::memory_order_acquire))
+		{
+			// Whoever is committing will probably cover this allocation as well
+			std::this_thread::yield();
+			continue;
+		}
+
+		// The page bookkeeping in IAllocator is only ever touched by the thread holding the committing flag
+		bool committed = true;
+		PtrSize const committed_size_Bytes = committed_Bytes.load(std::memory_order_relaxed);
+		if (committed_size_Bytes < end_Bytes)
+		{
+			// Grow by at least what's already committed so concurrent appends rarely end up here
+			PtrSize const required_page_count = CalcPageCountFromSize(end_Bytes - committed_size_Bytes);
+			PtrSize const current_page_count = GetPageCount();
+			PtrSize const grow_page_count = required_page_count > current_page_count ? required_page_count : current_page_count;
+			committed = AllocPages(grow_page_count) || (grow_page_count != required_page_count && AllocPages(required_page_count));
+			if (committed)
+			{
+				committed_Bytes.store(CalcMemorySizeBytes(), std::memory_order_release);
+			}
+		}
+
+		committing.store(false, std::memory_order_release);
+
+		if (!committed)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
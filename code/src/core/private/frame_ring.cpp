@@ -0,0 +1,132 @@
+#include <core/frame_ring.h>
+
+#include <core/assert.h>
+
+FrameRingAllocator::FrameRingAllocator(PtrSize chunk_size_bytes, PageConfig page_config)
+	: IAllocator(page_config)
+	, chunk_size_Bytes(chunk_size_bytes)
+{
+}
+
+FrameRingAllocator::~FrameRingAllocator()
+{
+}
+
+MemorySlice FrameRingAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
+{
+	if (current_chunk_index >= 0)
+	{
+		Chunk& chunk = chunks[current_chunk_index];
+		PtrSize const alignment_offset = CalcAlignmentOffset(chunk.ptr + chunk.used, alignment);
+		if (chunk.used + alignment_offset + size_Bytes <= chunk.size_bytes)
+		{
+			MemorySlice const result{chunk.ptr + chunk.used + alignment_offset, size_Bytes};
+			chunk.used += alignment_offset + size_Bytes;
+			chunk.last_frame = current_frame;
+			current_frame_Bytes += alignment_offset + size_Bytes;
+			return result;
+		}
+	}
+
+	// The current chunk is full, move on to the oldest chunk in the ring if its frames are done with it
+	PtrSize const worst_case_size_Bytes = size_Bytes + alignment - 1;
+	S32 next_chunk_index = current_chunk_index >= 0 ? chunks[current_chunk_index].next_chunk_index : -1;
+	if (next_chunk_index < 0 || !IsRetired(chunks[next_chunk_index]) || chunks[next_chunk_index].size_bytes < worst_case_size_Bytes)
+	{
+		next_chunk_index = AddChunk(worst_case_size_Bytes);
+		if (next_chunk_index < 0)
+		{
+			return {};
+		}
+	}
+
+	Chunk& chunk = chunks[next_chunk_index];
+	chunk.used = 0;
+	current_chunk_index = next_chunk_index;
+
+	PtrSize const alignment_offset = CalcAlignmentOffset(chunk.ptr, alignment);
+	chunk.used = alignment_offset + size_Bytes;
+	chunk.last_frame = current_frame;
+	current_frame_Bytes += alignment_offset + size_Bytes;
+
+	return {chunk.ptr + alignment_offset, size_Bytes};
+}
+
+void FrameRingAllocator::Free(MemorySlice /*memory*/)
+{
+}
+
+void FrameRingAllocator::BeginFrame(U64 frame)
+{
+	PAW_ASSERT(frame >= current_frame, "Frames have to increase");
+
+	last_frame_Bytes = current_frame_Bytes;
+	peak_frame_Bytes = current_frame_Bytes > peak_frame_Bytes ? current_frame_Bytes : peak_frame_Bytes;
+	current_frame_Bytes = 0;
+	current_frame = frame;
+}
+
+void FrameRingAllocator::RetireFrames(U64 completed_frame)
+{
+	PAW_ASSERT(completed_frame < current_frame, "The frame that's being recorded can't have retired yet");
+
+	if (completed_frame + 1 > first_live_frame)
+	{
+		first_live_frame = completed_frame + 1;
+	}
+}
+
+FrameRingStats FrameRingAllocator::GetStats() const
+{
+	return {
+		.current_frame_bytes = current_frame_Bytes,
+		.last_frame_bytes = last_frame_Bytes,
+		.peak_frame_bytes = current_frame_Bytes > peak_frame_Bytes ? current_frame_Bytes : peak_frame_Bytes,
+		.committed_bytes = GetCommittedBytes(),
+		.chunk_count = chunk_count,
+	};
+}
+
+bool FrameRingAllocator::IsRetired(Chunk const& chunk) const
+{
+	return chunk.used == 0 || chunk.last_frame < first_live_frame;
+}
+
+S32 FrameRingAllocator::AddChunk(PtrSize min_size_bytes)
+{
+	PAW_ASSERT(chunk_count < max_chunk_count, "The frame ring has run out of chunks, consider increasing the chunk size");
+	if (chunk_count >= max_chunk_count)
+	{
+		return -1;
+	}
+
+	// Grow geometrically so a ring that's too small for the workload settles after a few frames
+	PtrSize size_bytes = chunk_size_Bytes > min_size_bytes ? chunk_size_Bytes : min_size_bytes;
+	PtrSize const committed_bytes = CalcMemorySizeBytes();
+	size_bytes = size_bytes > committed_bytes / 2 ? size_bytes : committed_bytes / 2;
+
+	PtrSize const page_count = CalcPageCountFromSize(size_bytes);
+	Byte* const chunk_ptr = GetBaseAddress() + committed_bytes;
+	if (!AllocPages(page_count))
+	{
+		return -1;
+	}
+
+	S32 const chunk_index = chunk_count++;
+	Chunk& chunk = chunks[chunk_index];
+	chunk.ptr = chunk_ptr;
+	chunk.size_bytes = page_count * GetPageSize();
+
+	// Insert right after the current chunk so the chunk after the new one is still the oldest in the ring
+	if (current_chunk_index >= 0)
+	{
+		chunk.next_chunk_index = chunks[current_chunk_index].next_chunk_index;
+		chunks[current_chunk_index].next_chunk_index = chunk_index;
+	}
+	else
+	{
+		chunk.next_chunk_index = chunk_index;
+	}
+
+	return chunk_index;
+}
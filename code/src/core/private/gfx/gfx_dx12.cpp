@@ -1113,17 +1113,16 @@ Gfx::GraphBuilder& Gfx::CreateGraphBuilder(State& state, IAllocator* allocator)
 	RECT client_rect{};
 	GetClientRect(GetActiveWindow(), &client_rect);
 	state.graph_allocator.FreeAll();
-	GraphBuilder& builder = *PAW_NEW_IN(allocator, GraphBuilder)({
-																	 .width = client_rect.right - client_rect.left,
-																	 .height = client_rect.bottom - client_rect.top,
-																	 .format = state.swapchain_format,
-																	 .name = PAW_STR("Backbuffer"),
-																	 .initial_state = InitialState::Clear,
-																	 .clear_value = {.color = {1.0f, 1.0f, 0.53f, 1.0f}},
-																	 .sample_count = 1,
-																 },
-																 allocator,
-																 &state.graph_allocator);
+	GraphTextureDesc const backbuffer_desc = {
+		.width = client_rect.right - client_rect.left,
+		.height = client_rect.bottom - client_rect.top,
+		.format = state.swapchain_format,
+		.name = PAW_SID("Backbuffer"),
+		.initial_state = InitialState::Clear,
+		.clear_value = {.color = {1.0f, 1.0f, 0.53f, 1.0f}},
+		.sample_count = 1,
+	};
+	GraphBuilder& builder = *PAW_NEW_IN(allocator, GraphBuilder)(backbuffer_desc, allocator, &state.graph_allocator);
 	return builder;
 }
 
@@ -1137,7 +1136,7 @@ void Gfx::BuildGraph(State& state, GraphBuilder& builder)
 	state.current_graph = builder.Build(state);
 }
 
-Gfx::GraphPass& Gfx::GraphCreatePass(GraphBuilder& builder, StringView8 name)
+Gfx::GraphPass& Gfx::GraphCreatePass(GraphBuilder& builder, StringId name)
 {
 	return builder.AddPass(name);
 }
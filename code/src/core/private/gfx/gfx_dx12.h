@@ -1,6 +1,7 @@
 #include <core/gfx.h>
 #include <core/assert.h>
 #include <core/arena.h>
+#include <core/handle_pool.h>
 #include <core/memory_types.h>
 
 #pragma clang diagnostic push
@@ -44,93 +45,6 @@ static inline void SetDebugName(ID3D12Resource* resource, StringView8 const& nam
 	resource->SetPrivateData(WKPDID_D3DDebugObjectName, UINT(name.size_bytes), name.ptr);
 }
 
-template <typename T>
-struct Handle
-{
-	S32 index;
-	U32 generation;
-};
-
-template <typename T>
-class FixedSizePool : NonCopyable
-{
-public:
-	union Slot
-	{
-		T data;
-		S32 next_free_index;
-	};
-
-	static constexpr S32 null_slot = -1;
-
-	FixedSizePool() = default;
-
-	void Init(IAllocator* allocator, S32 count)
-	{
-		slots = PAW_NEW_SLICE_IN(allocator, count, Slot);
-		generations = PAW_NEW_SLICE_IN(allocator, count, U32);
-
-		for (S32 i = 0; i < slots.count - 1; ++i)
-		{
-			Slot& slot = slots[i];
-			new (&slot.next_free_index) S32(i + 1);
-		}
-		new (&slots[slots.count - 1].next_free_index) S32(-1);
-	}
-
-	FixedSizePool(IAllocator* allocator, S32 count)
-	{
-		Init(allocator, count);
-	}
-
-	~FixedSizePool()
-	{
-		PAW_DELETE_SLICE(slots);
-		PAW_DELETE_SLICE(generations);
-	}
-
-	void CheckHandle(Handle<T> handle)
-	{
-		U32 const generation = generations[handle.index];
-		PAW_ASSERT(handle.generation == generation, "Generations do not match");
-		PAW_ASSERT(handle.index != null_slot, "Index is null");
-		PAW_ASSERT(handle.index < slots.count, "Invalid index");
-		PAW_ASSERT(handle.index >= 0, "Invalid index");
-	}
-
-	Handle<T> Alloc()
-	{
-		PAW_ASSERT(first_free_index != null_slot, "No free slots");
-		S32 const index = first_free_index;
-		Slot& free_slot = slots[index];
-		first_free_index = free_slot.next_free_index;
-
-		new (&free_slot.data) T();
-		U32 const generation = generations[index];
-		return {index, generation};
-	}
-
-	void Free(Handle<T> handle)
-	{
-		CheckHandle(handle);
-		Slot& slot = slots[handle.index];
-		new (&slot.next_free_index) S32(first_free_index);
-		first_free_index = handle.index;
-		generations[handle.index]++;
-	}
-
-	T& GetValue(Handle<T> handle)
-	{
-		CheckHandle(handle);
-		return slots[handle.index].data;
-	}
-
-private:
-	Slice<Slot> slots;
-	Slice<U32> generations;
-	S32 first_free_index = 0;
-};
-
 enum class DescriptorType
 {
 	CbvSrvUav,
@@ -437,8 +351,8 @@ struct Gfx::State : NonCopyable
 	DescriptorPool descriptor_pool;
 	StaticTexturePool static_texture_pool;
 	CommandListAllocator command_list_allocator;
-	FixedSizePool<PipelineStateObject> pipeline_pool;
-	FixedSizePool<SamplerDescriptor> sampler_pool;
+	HandlePool<PipelineStateObject> pipeline_pool;
+	HandlePool<SamplerDescriptor> sampler_pool;
 
 	ID3D12CommandQueue* present_command_queue = nullptr;
 	HANDLE present_fence_event;
@@ -10,7 +10,7 @@ enum class ResourceOrigin
 
 struct Resource
 {
-	StringView8 name;
+	StringId name;
 	S32 width;
 	S32 height;
 	Gfx::Format format;
@@ -41,7 +41,7 @@ public:
 
 	GraphTexture GetBackBuffer();
 	GraphTexture CreateTexture(GraphPass& pass, GraphTextureDesc&& desc);
-	GraphPass& AddPass(StringView8 name);
+	GraphPass& AddPass(StringId name);
 	GraphTexture ReadTexture(GraphPass& pass, GraphTexture handle, Access access);
 	GraphTexture WriteTexture(GraphPass& pass, GraphTexture handle, Access access);
 	void SetExecutor(GraphPass& pass, GraphExecutor* executor);
@@ -4,6 +4,7 @@
 #include <core/slice.inl>
 #include <core/logger.h>
 #include <core/math.h>
+#include <core/scratch.h>
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wmicrosoft-enum-value"
@@ -60,7 +61,7 @@ static constexpr S32 g_null_depth_target_index = -1;
 
 struct RuntimeGraphPassDebugData
 {
-	StringView8 name;
+	StringId name;
 };
 
 struct RuntimeGraphClearColorCommand
@@ -96,7 +97,7 @@ struct RenderGraphPass;
 
 struct Gfx::GraphPass
 {
-	StringView8 name;
+	StringId name;
 	Gfx::GraphExecutor* executor;
 	ResourceInstanceRef* first_write_ref;
 	ResourceInstanceRef* current_write_ref;
@@ -136,7 +137,7 @@ struct RuntimeGraphResource_t
 
 struct RuntimeGraphResourceDebugData_t
 {
-	StringView8 name;
+	StringId name;
 	PtrSize size_bytes;
 	PtrSize offset_bytes;
 	S32 start_pass_index;
@@ -190,7 +191,7 @@ Gfx::GraphBuilder::GraphBuilder(Gfx::GraphTextureDesc in_backbuffer, IAllocator*
 		.origin = ResourceOrigin::Import,
 	};
 
-	backbuffer_instance = PAW_NEW_IN(allocator, ResourceInstance);
+	backbuffer_instance = PAW_NEW_IN(allocator, ResourceInstance)();
 	backbuffer_instance->resource = &backbuffer;
 	backbuffer_instance->ref_index = 0;
 
@@ -244,7 +245,7 @@ Gfx::GraphTexture Gfx::GraphBuilder::CreateTexture(Gfx::GraphPass& pass, Gfx::Gr
 	return {reinterpret_cast<U64>(ref)};
 }
 
-Gfx::GraphPass& Gfx::GraphBuilder::AddPass(StringView8 name)
+Gfx::GraphPass& Gfx::GraphBuilder::AddPass(StringId name)
 {
 	Gfx::GraphPass* pass = PAW_NEW_IN(allocator, Gfx::GraphPass)();
 	pass->name = name;
@@ -454,7 +455,7 @@ struct Gfx::Graph
 			RenderGraphPass const& pass = passes[pass_index];
 			RuntimeGraphPassDebugData const& pass_debug_data = passes_debug_data[pass_index];
 			//   PAW_ASSERT(pass_debug_data.name.null_terminated, ");
-			PIXBeginEvent(command_list, 0, PAW_STR_FMT, PAW_FMT_STR(pass_debug_data.name));
+			PIXBeginEvent(command_list, 0, PAW_STR_FMT, PAW_FMT_STR(StringIdGetString(pass_debug_data.name)));
 			//    TracyD3D12ZoneTransient(profiler_ctx, tracy_d3d12_zone, command_list, pass_debug_data.name.ptr, true);
 			if (pass.barrier_group_count > 0)
 			{
@@ -526,10 +527,13 @@ struct Gfx::Graph
 
 Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 {
+	// Everything here except the final graph is thrown away once it's built
+	ScratchScope const scratch(final_graph_allocator);
+	IAllocator* const scratch_allocator = scratch.GetAllocator();
 
-	Slice<S32> const visited_passes = PAW_NEW_SLICE_IN(allocator, pass_count, S32);
-	Slice<S32> const on_stack = PAW_NEW_SLICE_IN(allocator, pass_count, S32);
-	Slice<Gfx::GraphPass const*> const topological_order = PAW_NEW_SLICE_IN(allocator, pass_count, Gfx::GraphPass const*);
+	Slice<S32> const visited_passes = PAW_NEW_SLICE_IN(scratch_allocator, pass_count, S32);
+	Slice<S32> const on_stack = PAW_NEW_SLICE_IN(scratch_allocator, pass_count, S32);
+	Slice<Gfx::GraphPass const*> const topological_order = PAW_NEW_SLICE_IN(scratch_allocator, pass_count, Gfx::GraphPass const*);
 	S32 final_write_index = 0;
 
 	for (Gfx::GraphPass* pass = first_pass; pass; pass = pass->next_pass)
@@ -537,7 +541,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 		ProcessPass(pass, visited_passes, on_stack, topological_order, final_write_index);
 	}
 
-	Slice<S32> const distances = PAW_NEW_SLICE_IN(allocator, pass_count, S32);
+	Slice<S32> const distances = PAW_NEW_SLICE_IN(scratch_allocator, pass_count, S32);
 	for (Gfx::GraphPass const* pass : topological_order)
 	{
 		for (ResourceInstanceRef* write_ref = pass->first_write_ref; write_ref; write_ref = write_ref->next)
@@ -565,8 +569,8 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 
 	// PAW_LOG_INFO("====================================================================================================");
 
-	Slice<ResourceLifetime> const resource_lifetimes = PAW_NEW_SLICE_IN(allocator, resource_count, ResourceLifetime);
-	Slice<ResourceLifetime> const external_resource_lifetimes = PAW_NEW_SLICE_IN(allocator, external_resource_count, ResourceLifetime);
+	Slice<ResourceLifetime> const resource_lifetimes = PAW_NEW_SLICE_IN(scratch_allocator, resource_count, ResourceLifetime);
+	Slice<ResourceLifetime> const external_resource_lifetimes = PAW_NEW_SLICE_IN(scratch_allocator, external_resource_count, ResourceLifetime);
 	for (ResourceLifetime& lifetime : resource_lifetimes)
 	{
 		lifetime.start_pass_index = pass_count;
@@ -615,7 +619,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 	Slice<FinalResource> final_resources = PAW_NEW_SLICE_IN(final_graph_allocator, resource_count + external_resource_count, FinalResource);
 
 	{
-		Slice<ResourceLifetime> const sorted_resource_lifetimes = PAW_NEW_SLICE_IN(allocator, resource_lifetimes.count, ResourceLifetime);
+		Slice<ResourceLifetime> const sorted_resource_lifetimes = PAW_NEW_SLICE_UNINIT_IN(scratch_allocator, resource_lifetimes.count, ResourceLifetime);
 		std::memcpy(sorted_resource_lifetimes.items, resource_lifetimes.items, CalcTotalSizeBytes(sorted_resource_lifetimes));
 
 		for (ResourceLifetime& lifetime : sorted_resource_lifetimes)
@@ -670,9 +674,9 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 			Type type;
 		};
 
-		Slice<Bucket> const buckets = PAW_NEW_SLICE_IN(allocator, resource_count, Bucket);
-		Slice<Region> const regions = PAW_NEW_SLICE_IN(allocator, resource_count, Region);
-		Slice<UnaliasableOffset> const offsets_scratch = PAW_NEW_SLICE_IN(allocator, resource_count, UnaliasableOffset);
+		Slice<Bucket> const buckets = PAW_NEW_SLICE_IN(scratch_allocator, resource_count, Bucket);
+		Slice<Region> const regions = PAW_NEW_SLICE_IN(scratch_allocator, resource_count, Region);
+		Slice<UnaliasableOffset> const offsets_scratch = PAW_NEW_SLICE_IN(scratch_allocator, resource_count, UnaliasableOffset);
 		S32 bucket_count = 0;
 
 		static constexpr auto lifetime_intersects = [](S32 a_start, S32 a_end, S32 b_start, S32 b_end) -> bool
@@ -875,7 +879,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 			for (S32 frame_index = 0; frame_index < g_frames_in_flight; frame_index++)
 			{
 				DX_VERIFY(gfx_state.device->CreatePlacedResource2(heap, final_resource.offset_bytes + total_frame_heap_size_bytes * frame_index, &resource_desc, g_access_to_layout_map[U32(resource->last_access)], needs_clear_value ? &clear_value : nullptr, 0, nullptr, IID_PPV_ARGS(&final_resource.resources[frame_index])));
-				SetDebugName(final_resource.resources[frame_index], resource->name);
+				SetDebugName(final_resource.resources[frame_index], StringIdGetString(resource->name));
 			}
 		}
 
@@ -988,7 +992,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 		}
 	}
 
-	Gfx::Graph& runtime_graph = *PAW_NEW_IN(final_graph_allocator, Gfx::Graph);
+	Gfx::Graph& runtime_graph = *PAW_NEW_IN(final_graph_allocator, Gfx::Graph)();
 
 	runtime_graph.passes = PAW_NEW_SLICE_IN(final_graph_allocator, pass_count, RenderGraphPass);
 	runtime_graph.inputs = PAW_NEW_SLICE_IN(final_graph_allocator, total_input_count, RuntimeGraphPassInput_t);
@@ -1051,7 +1055,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 		}
 	};
 
-	Slice<ResourceTrackingState_t> const trackers = PAW_NEW_SLICE_IN(allocator, final_resources.count, ResourceTrackingState_t);
+	Slice<ResourceTrackingState_t> const trackers = PAW_NEW_SLICE_IN(scratch_allocator, final_resources.count, ResourceTrackingState_t);
 
 	for (S32 i = 0; i < final_resources.count; i++)
 	{
@@ -1346,7 +1350,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 		{
 			RuntimeGraphPassDebugData const& pass = runtime_graph.passes_debug_data[pass_index];
 			// {"id":"0","type":"text","text":"Scene View","x":-700,"y":-40,"width":360,"height":60},
-			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(pass.name), x, y, width_per_pass, height_per_pass, ",");
+			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(StringIdGetString(pass.name)), x, y, width_per_pass, height_per_pass, ",");
 			x += width_per_pass;
 			id++;
 		}
@@ -1360,7 +1364,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 			x = width_per_pass * resource.start_pass_index;
 			S32 const width = span_pass_count * width_per_pass;
 			// {"id":"0","type":"text","text":"Scene View","x":-700,"y":-40,"width":360,"height":60},
-			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(resource.name), x, y, width, height_per_pass, resource_index < runtime_graph.resources_debug_data.count - 1 ? "," : "");
+			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(StringIdGetString(resource.name)), x, y, width, height_per_pass, resource_index < runtime_graph.resources_debug_data.count - 1 ? "," : "");
 			y += height_per_pass;
 			id++;
 		}
@@ -1381,7 +1385,7 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 			F32 const heap_start_x = x_offset;
 			F32 const width = pixels_per_heap_byte * resource.size_bytes;
 			F32 const offset = pixels_per_heap_byte * resource.offset_bytes;
-			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(resource.name), S32(heap_start_x + offset), S32(y_offset), S32(width), S32(height_per_pass), ",");
+			walker += std::snprintf(buffer + walker, 2048, "\t\t{\"id\":\"%d\",\"type\":\"text\",\"text\":\"" PAW_STR_FMT "\",\"x\":%d,\"y\":%d,\"width\":%d,\"height\":%d}%s\n", id, PAW_FMT_STR(StringIdGetString(resource.name)), S32(heap_start_x + offset), S32(y_offset), S32(width), S32(height_per_pass), ",");
 
 			// ImGui::SetCursorPos(ImVec2(heap_start_x + offset, y_offset));
 			// ImGui::Button(resource.name.ptr, ImVec2(width, lifetime_height));
@@ -1416,13 +1420,13 @@ Gfx::Graph* Gfx::GraphBuilder::Build(Gfx::State& gfx_state)
 			for (ResourceInstanceRef* read_ref = pass->first_read_ref; read_ref; read_ref = read_ref->next)
 			{
 				Resource const* const resource = read_ref->instance->resource;
-				walker += std::snprintf(buffer + walker, 2048, "\tR%d{" PAW_STR_FMT "} -->|Read| P%d[" PAW_STR_FMT "]\n", resource->index, PAW_FMT_STR(resource->name), pass->index, PAW_FMT_STR(pass->name));
+				walker += std::snprintf(buffer + walker, 2048, "\tR%d{" PAW_STR_FMT "} -->|Read| P%d[" PAW_STR_FMT "]\n", resource->index, PAW_FMT_STR(StringIdGetString(resource->name)), pass->index, PAW_FMT_STR(StringIdGetString(pass->name)));
 			}
 
 			for (ResourceInstanceRef* write_ref = pass->first_write_ref; write_ref; write_ref = write_ref->next)
 			{
 				Resource const* const resource = write_ref->instance->resource;
-				walker += std::snprintf(buffer + walker, 2048, "\tP%d[" PAW_STR_FMT "] -->|Write| R%d{" PAW_STR_FMT "}\n", pass->index, PAW_FMT_STR(pass->name), resource->index, PAW_FMT_STR(resource->name));
+				walker += std::snprintf(buffer + walker, 2048, "\tP%d[" PAW_STR_FMT "] -->|Write| R%d{" PAW_STR_FMT "}\n", pass->index, PAW_FMT_STR(StringIdGetString(pass->name)), resource->index, PAW_FMT_STR(StringIdGetString(resource->name)));
 			}
 		}
 		/*for (S32 pass_index = 0; pass_index < runtime_graph.passes_debug_data.count; pass_index++)
@@ -0,0 +1,133 @@
+#include <core/hash.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PAW_HASH_SSE2 1
+#else
+#define PAW_HASH_SSE2 0
+#endif
+
+#if PAW_HASH_SSE2
+// Same steps as HashAccumulateStripe and HashScramble two lanes at a time. _mm_mul_epu32 multiplies the low 32 bits of
+// each 64-bit lane, shuffling the high halves down first gives the lo * hi product the scalar code computes.
+static void AccumulateStripeSse2(__m128i* acc, Byte const* data, U32 secret_offset)
+{
+	for (S32 i = 0; i < 4; i++)
+	{
+		__m128i const value = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data) + i);
+		__m128i const secret = _mm_loadu_si128(reinterpret_cast<__m128i const*>(g_hash_secret.values + secret_offset) + i);
+		__m128i const key = _mm_xor_si128(value, secret);
+		__m128i const key_high = _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1));
+		__m128i const product = _mm_mul_epu32(key, key_high);
+		__m128i const value_swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+		acc[i] = _mm_add_epi64(acc[i], _mm_add_epi64(product, value_swapped));
+	}
+}
+
+static void ScrambleSse2(__m128i* acc)
+{
+	__m128i const prime = _mm_set1_epi32(static_cast<int>(0x9E3779B1u));
+	for (S32 i = 0; i < 4; i++)
+	{
+		__m128i const secret = _mm_loadu_si128(reinterpret_cast<__m128i const*>(g_hash_secret.values + 24) + i);
+		__m128i value = _mm_xor_si128(acc[i], _mm_srli_epi64(acc[i], 47));
+		value = _mm_xor_si128(value, secret);
+		__m128i const product_low = _mm_mul_epu32(value, prime);
+		__m128i const product_high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+		acc[i] = _mm_add_epi64(product_low, _mm_slli_epi64(product_high, 32));
+	}
+}
+#endif
+
+void HashAccumulateSimd(U64* acc, Byte const* data, PtrSize stripe_count, U32& block_stripe)
+{
+#if PAW_HASH_SSE2
+	__m128i acc_sse2[4];
+	std::memcpy(acc_sse2, acc, sizeof(acc_sse2));
+	for (PtrSize stripe_index = 0; stripe_index < stripe_count; stripe_index++)
+	{
+		AccumulateStripeSse2(acc_sse2, data + stripe_index * hash_stripe_size_bytes, block_stripe);
+		if (++block_stripe == hash_stripes_per_block)
+		{
+			ScrambleSse2(acc_sse2);
+			block_stripe = 0;
+		}
+	}
+	std::memcpy(acc, acc_sse2, sizeof(acc_sse2));
+#else
+	HashAccumulateScalar(acc, data, stripe_count, block_stripe);
+#endif
+}
+
+U64 Hash64(void const* data, PtrSize size_bytes, U64 seed)
+{
+	return HashBytes(static_cast<Byte const*>(data), size_bytes, seed);
+}
+
+Hash64Stream::Hash64Stream(U64 seed)
+	: seed(seed)
+{
+	HashInitAccumulators(acc, seed);
+}
+
+void Hash64Stream::Update(void const* data, PtrSize size_bytes)
+{
+	Byte const* ptr = static_cast<Byte const*>(data);
+	total_size_bytes += size_bytes;
+	if (buffered_size_bytes + size_bytes <= hash_bulk_threshold_bytes)
+	{
+		std::memcpy(buffer + buffered_size_bytes, ptr, size_bytes);
+		buffered_size_bytes += size_bytes;
+		return;
+	}
+
+	// More data follows whatever fills the buffer, so every stripe in it comes before the last byte and can go into
+	// the accumulators now. The same goes for all but the tail of a large input.
+	if (buffered_size_bytes > 0)
+	{
+		PtrSize const fill_size_bytes = hash_bulk_threshold_bytes - buffered_size_bytes;
+		std::memcpy(buffer + buffered_size_bytes, ptr, fill_size_bytes);
+		ptr += fill_size_bytes;
+		size_bytes -= fill_size_bytes;
+		HashAccumulate(acc, buffer, hash_bulk_threshold_bytes / hash_stripe_size_bytes, block_stripe);
+		std::memcpy(previous_stripe, buffer + hash_bulk_threshold_bytes - hash_stripe_size_bytes, hash_stripe_size_bytes);
+	}
+
+	if (size_bytes > hash_bulk_threshold_bytes)
+	{
+		PtrSize const stripe_count = (size_bytes - 1) / hash_stripe_size_bytes;
+		HashAccumulate(acc, ptr, stripe_count, block_stripe);
+		ptr += stripe_count * hash_stripe_size_bytes;
+		size_bytes -= stripe_count * hash_stripe_size_bytes;
+		std::memcpy(previous_stripe, ptr - hash_stripe_size_bytes, hash_stripe_size_bytes);
+	}
+
+	std::memcpy(buffer, ptr, size_bytes);
+	buffered_size_bytes = size_bytes;
+}
+
+U64 Hash64Stream::Finish() const
+{
+	if (total_size_bytes <= hash_bulk_threshold_bytes)
+	{
+		return HashBytes(buffer, total_size_bytes, seed);
+	}
+
+	U64 final_acc[8];
+	std::memcpy(final_acc, acc, sizeof(final_acc));
+	U32 final_block_stripe = block_stripe;
+	HashAccumulate(final_acc, buffer, (buffered_size_bytes - 1) / hash_stripe_size_bytes, final_block_stripe);
+
+	Byte last_stripe[hash_stripe_size_bytes];
+	if (buffered_size_bytes >= hash_stripe_size_bytes)
+	{
+		std::memcpy(last_stripe, buffer + buffered_size_bytes - hash_stripe_size_bytes, hash_stripe_size_bytes);
+	}
+	else
+	{
+		PtrSize const previous_size_bytes = hash_stripe_size_bytes - buffered_size_bytes;
+		std::memcpy(last_stripe, previous_stripe + buffered_size_bytes, previous_size_bytes);
+		std::memcpy(last_stripe + previous_size_bytes, buffer, buffered_size_bytes);
+	}
+	return HashFinishBulk(final_acc, last_stripe, total_size_bytes);
+}
@@ -3,21 +3,45 @@
 #include <core/assert.h>
 #include <core/platform.h>
 
-union AllocatorSlot
+#include "memory_budget_internal.h"
+#include "memory_tracking_internal.h"
+#include "string_id_internal.h"
+
+#include <atomic>
+#include <cstring>
+
+struct AllocatorSlot
 {
-	IAllocator* allocator;
-	S32 next_free_slot_index;
+	std::atomic<IAllocator*> allocator;
+	std::atomic<S32> next_free_slot_index;
 };
 
 static constexpr S32 g_max_allocators = 256;
 static AllocatorSlot g_allocators[g_max_allocators]{};
-static S32 g_first_free_allocator_index = -1;
 
-static constexpr PtrSize g_page_size_bytes = KiloBytes(64);
-static constexpr PtrSize g_page_shift_count = 64 - __builtin_clzll(g_page_size_bytes) - 1;
+// Free slot list head: the low 32 bits are the slot index (-1 when empty), the high 32 bits are a tag that's bumped on
+// every push and pop so a head that was popped and pushed back in between a load and a CAS doesn't pass as unchanged
+static std::atomic<U64> g_free_allocator_list_head = 0xFFFFFFFF;
+
+static constexpr U64 PackFreeListHead(S32 index, U64 tag)
+{
+	return (tag << 32) | static_cast<U32>(index);
+}
+
+static constexpr S32 GetFreeListHeadIndex(U64 head)
+{
+	return static_cast<S32>(static_cast<U32>(head & 0xFFFFFFFF));
+}
+
+static constexpr U64 GetFreeListHeadTag(U64 head)
+{
+	return head >> 32;
+}
+
+static constexpr PtrSize g_small_page_size_bytes = KiloBytes(64);
+static constexpr PtrSize g_huge_page_size_bytes = MegaBytes(2);
 static constexpr PtrSize g_address_space_per_allocator_Bytes = GigaBytes(64);
 static constexpr PtrSize g_allocator_shift_count = 64 - __builtin_clzll(g_address_space_per_allocator_Bytes) - 1;
-static constexpr PtrSize g_page_count_per_allocator = g_address_space_per_allocator_Bytes / g_page_size_bytes;
 
 static Byte* g_base_address = nullptr;
 
@@ -30,87 +54,282 @@ static PtrSize CalcAllocatorIndex(Byte* ptr)
 
 static Byte* RegisterAllocator(IAllocator* allocator)
 {
-	PAW_ASSERT(g_first_free_allocator_index != -1, "Run out of allocator spaces");
 	PAW_ASSERT(g_base_address, "Initial address space is not allocated yet. Are you creating an allocator before the memory subsystem init");
 
-	S32 const index = g_first_free_allocator_index;
-	AllocatorSlot& slot = g_allocators[index];
-	g_first_free_allocator_index = slot.next_free_slot_index;
+	U64 head = g_free_allocator_list_head.load(std::memory_order_acquire);
+	S32 index = -1;
+	while (true)
+	{
+		index = GetFreeListHeadIndex(head);
+		PAW_ASSERT(index != -1, "Run out of allocator spaces");
+		if (index == -1)
+		{
+			return nullptr;
+		}
+
+		// The slot may be popped by another thread before our CAS, in which case this value is stale but the tag makes the CAS fail
+		S32 const next_index = g_allocators[index].next_free_slot_index.load(std::memory_order_relaxed);
+		U64 const new_head = PackFreeListHead(next_index, GetFreeListHeadTag(head) + 1);
+		if (g_free_allocator_list_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+		{
+			break;
+		}
+	}
+
+	g_allocators[index].allocator.store(allocator, std::memory_order_release);
 
 	Byte* const base_address = g_base_address + static_cast<PtrSize>(index) * g_address_space_per_allocator_Bytes;
+	return base_address;
+}
 
-	slot.allocator = allocator;
+static void UnregisterAllocator(S32 index)
+{
+	AllocatorSlot& slot = g_allocators[index];
+	slot.allocator.store(nullptr, std::memory_order_relaxed);
 
-	return base_address;
+	U64 head = g_free_allocator_list_head.load(std::memory_order_relaxed);
+	while (true)
+	{
+		slot.next_free_slot_index.store(GetFreeListHeadIndex(head), std::memory_order_relaxed);
+		U64 const new_head = PackFreeListHead(index, GetFreeListHeadTag(head) + 1);
+		if (g_free_allocator_list_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
 }
 
 void MemoryInit()
 {
-	PtrSize const address_space_bytes = static_cast<PtrSize>(g_max_allocators) * GigaBytes(64);
+	PtrSize const address_space_bytes = static_cast<PtrSize>(g_max_allocators) * g_address_space_per_allocator_Bytes;
 
 	for (S32 i = 0; i < g_max_allocators - 1; i++)
 	{
 		AllocatorSlot& slot = g_allocators[i];
-		slot.next_free_slot_index = i + 1;
+		slot.next_free_slot_index.store(i + 1, std::memory_order_relaxed);
 	}
 
-	g_allocators[g_max_allocators - 1].next_free_slot_index = -1;
-	g_first_free_allocator_index = 0;
+	g_allocators[g_max_allocators - 1].next_free_slot_index.store(-1, std::memory_order_relaxed);
+	g_free_allocator_list_head.store(PackFreeListHead(0, 0), std::memory_order_release);
 
-	Byte* const address_space = PlatformReserveAddressSpace(address_space_bytes);
-	g_base_address = address_space;
+	// Over-reserve by one huge page so every allocator's base address is huge page aligned
+	Byte* const address_space = PlatformReserveAddressSpace(address_space_bytes + g_huge_page_size_bytes);
+	g_base_address = AlignPointerForward(address_space, g_huge_page_size_bytes);
+
+	StringIdInit();
 }
 
 void MemoryDeinit()
 {
 }
 
-IAllocator::IAllocator()
+static PtrSize GetPageSizeBytes(PageMode mode)
+{
+	return mode == PageMode::Small ? g_small_page_size_bytes : g_huge_page_size_bytes;
+}
+
+static U32 GetCommitFlags(PageConfig config)
+{
+	U32 flags = PlatformCommitFlags_None;
+	if (config.mode == PageMode::Huge)
+	{
+		flags |= PlatformCommitFlags_HugePages;
+	}
+	else if (config.mode == PageMode::ExplicitHuge)
+	{
+		flags |= PlatformCommitFlags_ExplicitHugePages;
+	}
+
+	if (config.prefault)
+	{
+		flags |= PlatformCommitFlags_Prefault;
+	}
+	return flags;
+}
+
+IAllocator::IAllocator(PageConfig page_config)
 	: base_address(RegisterAllocator(this))
+	, page_size_bytes(GetPageSizeBytes(page_config.mode))
+	, page_shift_count(static_cast<U32>(63 - __builtin_clzll(GetPageSizeBytes(page_config.mode))))
+	, commit_flags(GetCommitFlags(page_config))
 {
 }
 
 IAllocator::~IAllocator()
 {
 	FreeAllPages();
+	DecommitPagesAbove(0);
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordAllocatorDestroyed(this);
+	}
+
+	UnregisterAllocator(GetAllocatorIndex());
+}
+
+bool IAllocator::TryResize(MemorySlice /*memory*/, PtrSize /*new_size_bytes*/)
+{
+	return false;
+}
+
+S32 IAllocator::GetAllocatorIndex() const
+{
+	return static_cast<S32>(CalcAllocatorIndex(base_address));
+}
+
+void IAllocator::SetRetentionPolicy(RetentionPolicy policy)
+{
+	retention_policy = policy;
+	frames_below_committed = 0;
+}
+
+PtrSize IAllocator::GetCommittedBytes() const
+{
+	return committed_page_count * page_size_bytes;
+}
+
+void IAllocator::SetMemoryCategory(MemoryCategory new_category)
+{
+	MemoryBudgetMoveCommitted(category, new_category, committed_page_count * page_size_bytes);
+	category = new_category;
+}
+
+MemoryCategory IAllocator::GetMemoryCategory() const
+{
+	return category;
+}
 
-	PtrSize const allocator_index = CalcAllocatorIndex(base_address);
-	AllocatorSlot& slot = g_allocators[allocator_index];
-	slot.next_free_slot_index = g_first_free_allocator_index;
-	g_first_free_allocator_index = allocator_index;
+void IAllocator::SetCommitLimit(PtrSize limit_bytes)
+{
+	commit_limit_bytes = limit_bytes;
 }
 
-void IAllocator::AllocPages(PtrSize count)
+bool IAllocator::AllocPages(PtrSize count)
 {
-	PAW_ASSERT(page_count < g_page_count_per_allocator, "Reached maximum page count per allocator");
+	PAW_ASSERT((page_count + count) * page_size_bytes <= g_address_space_per_allocator_Bytes, "Reached maximum page count per allocator");
+
+	PtrSize const new_page_count = page_count + count;
+
+	// Pages kept around by the retention policy are reused without going back to the OS
+	if (new_page_count > committed_page_count)
+	{
+		PtrSize const commit_Bytes = (new_page_count - committed_page_count) * page_size_bytes;
+		if (commit_limit_bytes != 0 && new_page_count * page_size_bytes > commit_limit_bytes)
+		{
+			return false;
+		}
+
+		if (!MemoryBudgetTryCommit(category, commit_Bytes))
+		{
+			return false;
+		}
+
+		Byte* const commit_address = base_address + committed_page_count * page_size_bytes;
+		PlatformCommitAddressSpace(commit_address, commit_Bytes, commit_flags);
+		committed_page_count = new_page_count;
+
+		if (IsMemoryTrackingRunning())
+		{
+			MemoryTrackingRecordCommit(this, committed_page_count * page_size_bytes);
+		}
+	}
+
+	page_count = new_page_count;
+	peak_page_count = page_count > peak_page_count ? page_count : peak_page_count;
 
-	Byte* const new_page_address = base_address + page_count * g_page_size_bytes;
-	PlatformCommitAddressSpace(new_page_address, g_page_size_bytes * count);
-	page_count += count;
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordPages(this, page_count * page_size_bytes);
+	}
+	return true;
 }
 
 void IAllocator::FreePages(PtrSize shrink_count)
 {
 	PAW_ASSERT(page_count >= shrink_count, "You are requesting to free more pages than the allocator owns");
 
-	PtrSize const free_Bytes = shrink_count * g_page_size_bytes;
-	PtrSize const start_offset_Bytes = (page_count - shrink_count) * g_page_size_bytes;
+	PtrSize const free_Bytes = shrink_count * page_size_bytes;
+	PtrSize const start_offset_Bytes = (page_count - shrink_count) * page_size_bytes;
 	Byte* const free_ptr = base_address + start_offset_Bytes;
 
-	PlatformDecommitAddressSpace(free_ptr, free_Bytes);
-
 	page_count -= shrink_count;
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordReleaseRange({free_ptr, free_Bytes}, this);
+		MemoryTrackingRecordPages(this, page_count * page_size_bytes);
+	}
+
+	// With a frame based policy the trimming waits for the next FreeAllPages
+	if (retention_policy.decommit_after_frames == 0)
+	{
+		PtrSize const keep_page_count = CalcPageCountFromSize(retention_policy.keep_committed_bytes);
+		DecommitPagesAbove(page_count > keep_page_count ? page_count : keep_page_count);
+	}
+}
+
+void IAllocator::PurgePages(Byte* ptr, PtrSize count)
+{
+	PAW_ASSERT(ptr >= base_address && ptr + count * page_size_bytes <= base_address + page_count * page_size_bytes, "You are purging pages the allocator doesn't own");
+	PAW_ASSERT(IsPointerAligned(ptr, page_size_bytes), "Purged pages have to be page aligned");
+
+	PlatformPurgeAddressSpace(ptr, count * page_size_bytes);
 }
 
 void IAllocator::FreeAllPages()
 {
-	PlatformDecommitAddressSpace(base_address, page_count * g_page_size_bytes);
+	if (IsMemoryTrackingRunning())
+	{
+		// Everything the allocator handed out from its pages lies below the committed end
+		MemoryTrackingRecordReleaseRange({base_address, committed_page_count * page_size_bytes}, this);
+		MemoryTrackingRecordPages(this, 0);
+	}
+
+	PtrSize const frame_peak_page_count = peak_page_count;
 	page_count = 0;
+	peak_page_count = 0;
+
+	PtrSize retained_page_count = CalcPageCountFromSize(retention_policy.keep_committed_bytes);
+	if (retention_policy.decommit_after_frames > 0)
+	{
+		frames_below_committed = frame_peak_page_count < committed_page_count ? frames_below_committed + 1 : 0;
+		if (frames_below_committed < retention_policy.decommit_after_frames)
+		{
+			retained_page_count = committed_page_count;
+		}
+		else
+		{
+			retained_page_count = frame_peak_page_count > retained_page_count ? frame_peak_page_count : retained_page_count;
+			frames_below_committed = 0;
+		}
+	}
+
+	DecommitPagesAbove(retained_page_count);
+}
+
+void IAllocator::DecommitPagesAbove(PtrSize retained_page_count)
+{
+	if (retained_page_count >= committed_page_count)
+	{
+		return;
+	}
+
+	Byte* const decommit_address = base_address + retained_page_count * page_size_bytes;
+	PtrSize const decommit_Bytes = (committed_page_count - retained_page_count) * page_size_bytes;
+	PlatformDecommitAddressSpace(decommit_address, decommit_Bytes, commit_flags);
+	MemoryBudgetDecommit(category, decommit_Bytes);
+	committed_page_count = retained_page_count;
+
+	if (IsMemoryTrackingRunning())
+	{
+		MemoryTrackingRecordCommit(this, committed_page_count * page_size_bytes);
+	}
 }
 
 PtrSize IAllocator::CalcMemorySizeBytes()
 {
-	return page_count * g_page_size_bytes;
+	return page_count * page_size_bytes;
 }
 
 PtrSize IAllocator::GetPageCount() const
@@ -123,35 +342,82 @@ Byte* IAllocator::GetBaseAddress() const
 	return base_address;
 }
 
-PtrSize IAllocator::GetPageSize()
+PtrSize IAllocator::GetPageSize() const
 {
-	return g_page_size_bytes;
+	return page_size_bytes;
 }
 
-PtrSize IAllocator::CalcPageCountFromSize(PtrSize size_bytes)
+PtrSize IAllocator::CalcPageCountFromSize(PtrSize size_bytes) const
 {
-	PtrSize const page_count = ((size_bytes + g_page_size_bytes) >> g_page_shift_count);
-	return page_count;
+	PtrSize const result = ((size_bytes + page_size_bytes - 1) >> page_shift_count);
+	return result;
 }
 
 static thread_local IAllocator* g_default_allocator = nullptr;
 
-MemorySlice AllocMem(PtrSize size, PtrSize alignment, IAllocator* allocator, SrcLocation /*src*/)
+MemorySlice AllocMem(PtrSize size, PtrSize alignment, IAllocator* allocator, SrcLocation src)
 {
 	IAllocator* allocator_to_use = allocator ? allocator : g_default_allocator;
 	PAW_ASSERT(allocator_to_use, "There is no active allocator to use, either pass one in or set an allocator scope");
-	return allocator_to_use->Alloc(size, alignment);
+	MemorySlice const result = allocator_to_use->Alloc(size, alignment);
+
+	if (IsMemoryTrackingRunning() && result.ptr)
+	{
+		MemoryTrackingRecordAlloc(result, allocator_to_use, src);
+	}
+
+	return result;
 }
 
-void FreeMem(MemorySlice slice, IAllocator* allocator, SrcLocation /*src*/)
+void FreeMem(MemorySlice slice, IAllocator* allocator, SrcLocation src)
 {
 	PtrSize const allocator_index = CalcAllocatorIndex(slice.ptr);
 	PAW_ASSERT(allocator_index < g_max_allocators, "Allocator index not in range");
-	IAllocator* allocator_to_use = allocator ? allocator : g_allocators[allocator_index].allocator;
+	IAllocator* allocator_to_use = allocator ? allocator : g_allocators[allocator_index].allocator.load(std::memory_order_acquire);
 	PAW_ASSERT(allocator_to_use, "There is no active allocator to use, either pass one in or set an allocator scope");
+
+	if (IsMemoryTrackingRunning() && slice.ptr)
+	{
+		MemoryTrackingRecordFree(slice, allocator_to_use, src);
+	}
+
 	allocator_to_use->Free(slice);
 }
 
+MemorySlice ResizeMem(MemorySlice slice, PtrSize new_size, PtrSize alignment, IAllocator* allocator, SrcLocation src)
+{
+	if (slice.ptr == nullptr)
+	{
+		return AllocMem(new_size, alignment, allocator, src);
+	}
+
+	PtrSize const allocator_index = CalcAllocatorIndex(slice.ptr);
+	PAW_ASSERT(allocator_index < g_max_allocators, "Allocator index not in range");
+	IAllocator* allocator_to_use = allocator ? allocator : g_allocators[allocator_index].allocator.load(std::memory_order_acquire);
+	PAW_ASSERT(allocator_to_use, "There is no active allocator to use, either pass one in or set an allocator scope");
+
+	if (allocator_to_use->TryResize(slice, new_size))
+	{
+		MemorySlice const result{slice.ptr, new_size};
+		if (IsMemoryTrackingRunning())
+		{
+			MemoryTrackingRecordFree(slice, allocator_to_use, src);
+			MemoryTrackingRecordAlloc(result, allocator_to_use, src);
+		}
+		return result;
+	}
+
+	MemorySlice const result = AllocMem(new_size, alignment, allocator_to_use, src);
+	if (result.ptr == nullptr)
+	{
+		return {};
+	}
+
+	std::memcpy(result.ptr, slice.ptr, slice.size_bytes < new_size ? slice.size_bytes : new_size);
+	FreeMem(slice, allocator_to_use, src);
+	return result;
+}
+
 PtrSize CalcAlignmentOffset(Byte* ptr, PtrSize alignment)
 {
 	U64 alignment_offset = 0;
@@ -0,0 +1,144 @@
+#include <core/memory_budget.h>
+
+#include <core/assert.h>
+
+#include "memory_budget_internal.h"
+
+#include <atomic>
+
+struct BudgetState
+{
+	std::atomic<PtrSize> committed_bytes = 0;
+	std::atomic<PtrSize> soft_limit_bytes = 0;
+	std::atomic<PtrSize> hard_limit_bytes = 0;
+	std::atomic<MemoryBudgetCallback> on_soft_limit = nullptr;
+	std::atomic<void*> user_data = nullptr;
+};
+
+static constexpr S32 g_category_count = static_cast<S32>(MemoryCategory::Count);
+
+static BudgetState g_category_budgets[g_category_count]{};
+static BudgetState g_total_budget{};
+
+static BudgetState& GetCategoryBudget(MemoryCategory category)
+{
+	PAW_ASSERT(category < MemoryCategory::Count, "Memory category is not in range");
+	return g_category_budgets[static_cast<S32>(category)];
+}
+
+static void SetBudget(BudgetState& state, MemoryBudget const& budget)
+{
+	state.soft_limit_bytes.store(budget.soft_limit_bytes, std::memory_order_relaxed);
+	state.hard_limit_bytes.store(budget.hard_limit_bytes, std::memory_order_relaxed);
+	state.on_soft_limit.store(budget.on_soft_limit, std::memory_order_relaxed);
+	state.user_data.store(budget.user_data, std::memory_order_relaxed);
+}
+
+// CAS instead of fetch_add so a commit that would go over the hard limit never shows up in the counter, not even briefly
+static bool TryAddCommitted(BudgetState& state, PtrSize size_bytes, PtrSize& out_previous_bytes)
+{
+	PtrSize const hard_limit_bytes = state.hard_limit_bytes.load(std::memory_order_relaxed);
+	PtrSize committed_bytes = state.committed_bytes.load(std::memory_order_relaxed);
+	do
+	{
+		if (hard_limit_bytes != 0 && committed_bytes + size_bytes > hard_limit_bytes)
+		{
+			return false;
+		}
+	} while (!state.committed_bytes.compare_exchange_weak(committed_bytes, committed_bytes + size_bytes, std::memory_order_relaxed));
+
+	out_previous_bytes = committed_bytes;
+	return true;
+}
+
+static void NotifySoftLimit(BudgetState& state, MemoryCategory category, PtrSize previous_bytes, PtrSize size_bytes)
+{
+	PtrSize const soft_limit_bytes = state.soft_limit_bytes.load(std::memory_order_relaxed);
+	bool const crossed = soft_limit_bytes != 0 && previous_bytes < soft_limit_bytes && previous_bytes + size_bytes >= soft_limit_bytes;
+	if (!crossed)
+	{
+		return;
+	}
+
+	MemoryBudgetCallback const callback = state.on_soft_limit.load(std::memory_order_relaxed);
+	if (callback)
+	{
+		callback(category, previous_bytes + size_bytes, state.user_data.load(std::memory_order_relaxed));
+	}
+}
+
+bool MemoryBudgetTryCommit(MemoryCategory category, PtrSize size_bytes)
+{
+	BudgetState& category_budget = GetCategoryBudget(category);
+
+	PtrSize previous_category_bytes = 0;
+	if (!TryAddCommitted(category_budget, size_bytes, previous_category_bytes))
+	{
+		return false;
+	}
+
+	PtrSize previous_total_bytes = 0;
+	if (!TryAddCommitted(g_total_budget, size_bytes, previous_total_bytes))
+	{
+		category_budget.committed_bytes.fetch_sub(size_bytes, std::memory_order_relaxed);
+		return false;
+	}
+
+	NotifySoftLimit(category_budget, category, previous_category_bytes, size_bytes);
+	NotifySoftLimit(g_total_budget, MemoryCategory::Count, previous_total_bytes, size_bytes);
+	return true;
+}
+
+void MemoryBudgetDecommit(MemoryCategory category, PtrSize size_bytes)
+{
+	GetCategoryBudget(category).committed_bytes.fetch_sub(size_bytes, std::memory_order_relaxed);
+	g_total_budget.committed_bytes.fetch_sub(size_bytes, std::memory_order_relaxed);
+}
+
+void MemoryBudgetMoveCommitted(MemoryCategory from, MemoryCategory to, PtrSize size_bytes)
+{
+	GetCategoryBudget(from).committed_bytes.fetch_sub(size_bytes, std::memory_order_relaxed);
+	GetCategoryBudget(to).committed_bytes.fetch_add(size_bytes, std::memory_order_relaxed);
+}
+
+void MemorySetCategoryBudget(MemoryCategory category, MemoryBudget budget)
+{
+	SetBudget(GetCategoryBudget(category), budget);
+}
+
+void MemorySetTotalBudget(MemoryBudget budget)
+{
+	SetBudget(g_total_budget, budget);
+}
+
+PtrSize MemoryGetCommittedBytes()
+{
+	return g_total_budget.committed_bytes.load(std::memory_order_relaxed);
+}
+
+PtrSize MemoryGetCommittedBytes(MemoryCategory category)
+{
+	return GetCategoryBudget(category).committed_bytes.load(std::memory_order_relaxed);
+}
+
+char const* GetMemoryCategoryName(MemoryCategory category)
+{
+	switch (category)
+	{
+		case MemoryCategory::General:
+			return "General";
+		case MemoryCategory::RenderGraph:
+			return "RenderGraph";
+		case MemoryCategory::UI:
+			return "UI";
+		case MemoryCategory::ECS:
+			return "ECS";
+		case MemoryCategory::Fonts:
+			return "Fonts";
+		case MemoryCategory::Temp:
+			return "Temp";
+		case MemoryCategory::Count:
+			break;
+	}
+	return "Unknown";
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <core/memory_types.h>
+
+// Counts the bytes against the category and the global total. Returns false and counts nothing if either hard limit would be exceeded.
+bool MemoryBudgetTryCommit(MemoryCategory category, PtrSize size_bytes);
+void MemoryBudgetDecommit(MemoryCategory category, PtrSize size_bytes);
+// Re-tags already committed bytes, never fails
+void MemoryBudgetMoveCommitted(MemoryCategory from, MemoryCategory to, PtrSize size_bytes);
@@ -0,0 +1,134 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <core/platform.h>
+
+#include <core/assert.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// The whole allocator address space is reserved once as an inaccessible, unbacked mapping. Committing flips the
+// protection on a sub-range and decommitting hands the physical pages back while keeping the range reserved, so the
+// pointer -> allocator lookup in memory.cpp stays a single shift.
+
+Byte* PlatformReserveAddressSpace(PtrSize size_bytes)
+{
+	// MAP_NORESERVE + PROT_NONE means nothing is charged against overcommit until a range gets committed
+	void* const address_space = mmap(nullptr, size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	PAW_ASSERT(address_space != MAP_FAILED, "Failed to reserve address space");
+	if (address_space == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<Byte*>(address_space);
+}
+
+static void PrefaultPages(Byte* start_ptr, PtrSize size_bytes)
+{
+#if defined(MADV_POPULATE_WRITE)
+	if (madvise(start_ptr, size_bytes, MADV_POPULATE_WRITE) == 0)
+	{
+		return;
+	}
+#endif
+
+	// Read and write back the same value so lazily decommitted contents survive
+	PtrSize const os_page_size_bytes = static_cast<PtrSize>(sysconf(_SC_PAGESIZE));
+	for (PtrSize offset = 0; offset < size_bytes; offset += os_page_size_bytes)
+	{
+		Byte volatile* const ptr = start_ptr + offset;
+		*ptr = *ptr;
+	}
+}
+
+void PlatformCommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 flags)
+{
+	if ((flags & PlatformCommitFlags_ExplicitHugePages) != 0)
+	{
+#if defined(MAP_HUGETLB)
+		// hugetlbfs pages can't be switched on with mprotect, so the reserved range is replaced with a huge page mapping
+		int const populate = (flags & PlatformCommitFlags_Prefault) != 0 ? MAP_POPULATE : 0;
+		void* const result = mmap(start_ptr, size_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB | populate, -1, 0);
+		if (result != MAP_FAILED)
+		{
+			return;
+		}
+
+		// The huge page pool is empty or not configured, put a normal mapping back and use transparent huge pages instead.
+		// A failed MAP_FIXED mmap may have already unmapped the range, so this can't just mprotect.
+		void* const fallback = mmap(start_ptr, size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+		PAW_ASSERT(fallback != MAP_FAILED, "Failed to restore the reservation after a huge page commit failed");
+		PAW_UNUSED_ARG(fallback);
+#endif
+		flags |= PlatformCommitFlags_HugePages;
+	}
+
+	int const result = mprotect(start_ptr, size_bytes, PROT_READ | PROT_WRITE);
+	PAW_ASSERT(result == 0, "Failed to commit address space");
+	PAW_UNUSED_ARG(result);
+
+#if defined(MADV_HUGEPAGE)
+	if ((flags & PlatformCommitFlags_HugePages) != 0)
+	{
+		// Only a hint, it does nothing if transparent huge pages are disabled
+		madvise(start_ptr, size_bytes, MADV_HUGEPAGE);
+	}
+#endif
+
+	if ((flags & PlatformCommitFlags_Prefault) != 0)
+	{
+		PrefaultPages(start_ptr, size_bytes);
+	}
+}
+
+void PlatformDecommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 flags)
+{
+	if (size_bytes == 0)
+	{
+		return;
+	}
+
+	if ((flags & PlatformCommitFlags_ExplicitHugePages) != 0)
+	{
+		// Mapping the reservation back over the range releases whichever kind of page ended up backing it
+		void* const result = mmap(start_ptr, size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+		PAW_ASSERT(result != MAP_FAILED, "Failed to decommit address space");
+		PAW_UNUSED_ARG(result);
+		return;
+	}
+
+	// MADV_DONTNEED drops the pages immediately so recommitted memory reads back as zero, matching MEM_DECOMMIT.
+	// PAW_MEMORY_LAZY_DECOMMIT switches to MADV_FREE, which lets the kernel reclaim the pages only under memory pressure.
+	// That is cheaper when the same range is recommitted soon, but the old contents may still be there afterwards.
+#if defined(PAW_MEMORY_LAZY_DECOMMIT) && defined(MADV_FREE)
+	int const advise_result = madvise(start_ptr, size_bytes, MADV_FREE);
+#else
+	int const advise_result = madvise(start_ptr, size_bytes, MADV_DONTNEED);
+#endif
+	PAW_ASSERT(advise_result == 0, "Failed to release decommitted pages");
+	PAW_UNUSED_ARG(advise_result);
+
+	int const protect_result = mprotect(start_ptr, size_bytes, PROT_NONE);
+	PAW_ASSERT(protect_result == 0, "Failed to decommit address space");
+	PAW_UNUSED_ARG(protect_result);
+}
+
+void PlatformPurgeAddressSpace(Byte* start_ptr, PtrSize size_bytes)
+{
+	if (size_bytes == 0)
+	{
+		return;
+	}
+
+	// Same advice as PlatformDecommitAddressSpace but the protection stays, the next touch faults in a fresh page
+#if defined(PAW_MEMORY_LAZY_DECOMMIT) && defined(MADV_FREE)
+	int const result = madvise(start_ptr, size_bytes, MADV_FREE);
+#else
+	int const result = madvise(start_ptr, size_bytes, MADV_DONTNEED);
+#endif
+	PAW_ASSERT(result == 0, "Failed to purge address space");
+	PAW_UNUSED_ARG(result);
+}
+
+#endif
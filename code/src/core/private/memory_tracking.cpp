@@ -0,0 +1,920 @@
+#include <core/memory_tracking.h>
+
+#include <core/arena.h>
+#include <core/assert.h>
+#include <core/memory.h>
+#include <core/slice.inl>
+
+#include "memory_tracking_internal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+std::atomic<bool> g_memory_tracking_running = false;
+
+enum class TrackingEventType : U8
+{
+	Alloc,
+	Free,
+	ReleaseRange,
+	Pages,
+	Commit,
+	AllocatorDestroyed,
+};
+
+struct TrackingEvent
+{
+	// Global order the events happened in, pending events are applied sorted by it
+	U64 sequence;
+	TrackingEventType type;
+	S32 allocator_index;
+	Byte* ptr;
+	PtrSize size_bytes;
+	SrcLocation src;
+};
+
+struct LiveAllocation
+{
+	Byte* ptr;
+	PtrSize size_bytes;
+	S32 callsite_index;
+	S32 allocator_index;
+};
+
+static constexpr S32 g_max_tracked_allocators = 256;
+static constexpr S32 g_null_index = -1;
+
+// Everything below is only touched with g_tracking_mutex held
+static std::mutex g_tracking_mutex;
+
+// Callsites live in a dense array so live allocations can point at them by index across rehashes
+static Slice<MemoryCallsiteStats> g_callsites;
+static S32 g_callsite_count = 0;
+static Slice<S32> g_callsite_lookup;
+
+// One table per allocator slot, so releasing a range only has to look at the allocations of the allocator releasing it
+struct LiveAllocationTable
+{
+	Slice<LiveAllocation> slots;
+	S32 count = 0;
+};
+
+static MemoryAllocatorStats g_allocator_stats[g_max_tracked_allocators]{};
+static LiveAllocationTable g_live_allocations[g_max_tracked_allocators]{};
+static U64 g_untracked_free_count = 0;
+static U64 g_overwritten_allocation_count = 0;
+
+// Events copied out of the thread buffers that haven't been applied yet, because an earlier one might still be on its
+// way from another thread
+static Slice<TrackingEvent> g_pending_events;
+static S32 g_pending_event_count = 0;
+
+static std::atomic<U64> g_next_event_sequence = 0;
+static constexpr U64 g_no_sequence = ~0ull;
+
+// Set while the tracker itself is working so the tracker's own allocator doesn't feed events back into it
+static thread_local bool g_inside_tracker = false;
+
+static ArenaAllocator& GetTrackingAllocator()
+{
+	static ArenaAllocator allocator{};
+	return allocator;
+}
+
+static U64 HashPointer(void const* ptr)
+{
+	U64 x = reinterpret_cast<U64>(ptr);
+	x ^= x >> 33;
+	x *= 0xFF51AFD7ED558CCDull;
+	x ^= x >> 33;
+	return x;
+}
+
+static U64 HashSrcLocation(SrcLocation const& src)
+{
+	return HashPointer(src.file) ^ (HashPointer(src.function) * 31) ^ (static_cast<U64>(src.line) << 16) ^ static_cast<U64>(src.column);
+}
+
+static bool SrcLocationsEqual(SrcLocation const& a, SrcLocation const& b)
+{
+	return a.file == b.file && a.function == b.function && a.line == b.line && a.column == b.column;
+}
+
+template <typename T>
+static Slice<T> AllocTrackingSlice(S32 count)
+{
+	MemorySlice const memory = GetTrackingAllocator().Alloc(sizeof(T) * static_cast<PtrSize>(count), alignof(T));
+	T* const items = reinterpret_cast<T*>(memory.ptr);
+	for (S32 i = 0; i < count; i++)
+	{
+		new (items + i) T();
+	}
+	return Slice<T>{items, count};
+}
+
+static void RebuildCallsiteLookup(S32 capacity)
+{
+	// The old lookup stays behind in the arena, the waste is bounded by the geometric growth
+	g_callsite_lookup = AllocTrackingSlice<S32>(capacity);
+	for (S32& index : g_callsite_lookup)
+	{
+		index = g_null_index;
+	}
+
+	U64 const mask = static_cast<U64>(capacity - 1);
+	for (S32 callsite_index = 0; callsite_index < g_callsite_count; callsite_index++)
+	{
+		U64 slot = HashSrcLocation(g_callsites[callsite_index].src) & mask;
+		while (g_callsite_lookup[static_cast<S32>(slot)] != g_null_index)
+		{
+			slot = (slot + 1) & mask;
+		}
+		g_callsite_lookup[static_cast<S32>(slot)] = callsite_index;
+	}
+}
+
+static S32 FindOrAddCallsite(SrcLocation const& src)
+{
+	if ((g_callsite_count + 1) * 2 > g_callsite_lookup.count)
+	{
+		S32 const new_capacity = g_callsite_lookup.count > 0 ? g_callsite_lookup.count * 2 : 1024;
+		Slice<MemoryCallsiteStats> const new_callsites = AllocTrackingSlice<MemoryCallsiteStats>(new_capacity / 2);
+		for (S32 i = 0; i < g_callsite_count; i++)
+		{
+			new_callsites[i] = g_callsites[i];
+		}
+		g_callsites = new_callsites;
+		RebuildCallsiteLookup(new_capacity);
+	}
+
+	U64 const mask = static_cast<U64>(g_callsite_lookup.count - 1);
+	U64 slot = HashSrcLocation(src) & mask;
+	while (true)
+	{
+		S32 const callsite_index = g_callsite_lookup[static_cast<S32>(slot)];
+		if (callsite_index == g_null_index)
+		{
+			S32 const new_index = g_callsite_count++;
+			g_callsites[new_index] = MemoryCallsiteStats{.src = src};
+			g_callsite_lookup[static_cast<S32>(slot)] = new_index;
+			return new_index;
+		}
+
+		if (SrcLocationsEqual(g_callsites[callsite_index].src, src))
+		{
+			return callsite_index;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+static void InsertLiveAllocation(LiveAllocationTable& table, LiveAllocation const& allocation);
+static void ReleaseLiveAllocation(LiveAllocation const& allocation);
+
+static void GrowLiveAllocations(LiveAllocationTable& table)
+{
+	Slice<LiveAllocation> const old_allocations = table.slots;
+	S32 const new_capacity = old_allocations.count > 0 ? old_allocations.count * 2 : 256;
+	table.slots = AllocTrackingSlice<LiveAllocation>(new_capacity);
+	table.count = 0;
+	for (LiveAllocation const& allocation : old_allocations)
+	{
+		if (allocation.ptr != nullptr)
+		{
+			InsertLiveAllocation(table, allocation);
+		}
+	}
+}
+
+static void InsertLiveAllocation(LiveAllocationTable& table, LiveAllocation const& allocation)
+{
+	if ((table.count + 1) * 2 > table.slots.count)
+	{
+		GrowLiveAllocations(table);
+	}
+
+	U64 const mask = static_cast<U64>(table.slots.count - 1);
+	U64 slot = HashPointer(allocation.ptr) & mask;
+	while (table.slots[static_cast<S32>(slot)].ptr != nullptr && table.slots[static_cast<S32>(slot)].ptr != allocation.ptr)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	if (table.slots[static_cast<S32>(slot)].ptr == nullptr)
+	{
+		table.count++;
+	}
+	else
+	{
+		// The previous allocation at this address went away without a Free or release the tracker saw
+		ReleaseLiveAllocation(table.slots[static_cast<S32>(slot)]);
+		g_overwritten_allocation_count++;
+	}
+	table.slots[static_cast<S32>(slot)] = allocation;
+}
+
+static S32 FindLiveAllocation(LiveAllocationTable const& table, Byte* ptr)
+{
+	if (table.count == 0)
+	{
+		return g_null_index;
+	}
+
+	U64 const mask = static_cast<U64>(table.slots.count - 1);
+	U64 slot = HashPointer(ptr) & mask;
+	while (table.slots[static_cast<S32>(slot)].ptr != nullptr)
+	{
+		if (table.slots[static_cast<S32>(slot)].ptr == ptr)
+		{
+			return static_cast<S32>(slot);
+		}
+		slot = (slot + 1) & mask;
+	}
+	return g_null_index;
+}
+
+// Backward shift deletion, so lookups never have to step over tombstones
+static void RemoveLiveAllocationAt(LiveAllocationTable& table, S32 slot_index)
+{
+	U64 const mask = static_cast<U64>(table.slots.count - 1);
+	U64 hole = static_cast<U64>(slot_index);
+	U64 slot = (hole + 1) & mask;
+	while (table.slots[static_cast<S32>(slot)].ptr != nullptr)
+	{
+		U64 const home = HashPointer(table.slots[static_cast<S32>(slot)].ptr) & mask;
+		// Only move the entry back if its home slot isn't between the hole and where it currently sits
+		bool const can_move = ((slot - home) & mask) >= ((slot - hole) & mask);
+		if (can_move)
+		{
+			table.slots[static_cast<S32>(hole)] = table.slots[static_cast<S32>(slot)];
+			hole = slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+	table.slots[static_cast<S32>(hole)] = {};
+	table.count--;
+}
+
+// Drops every live allocation of the table inside [begin, end)
+static void ReleaseLiveAllocationsInRange(LiveAllocationTable& table, Byte* begin, Byte* end)
+{
+	S32 slot_index = 0;
+	while (table.count > 0 && slot_index < table.slots.count)
+	{
+		LiveAllocation const& allocation = table.slots[slot_index];
+		if (allocation.ptr != nullptr && allocation.ptr >= begin && allocation.ptr < end)
+		{
+			ReleaseLiveAllocation(allocation);
+			// The backward shift can pull an unvisited entry into this slot, so look at it again
+			RemoveLiveAllocationAt(table, slot_index);
+			continue;
+		}
+		slot_index++;
+	}
+}
+
+static void ReleaseLiveAllocation(LiveAllocation const& allocation)
+{
+	MemoryCallsiteStats& callsite = g_callsites[allocation.callsite_index];
+	callsite.free_count++;
+	callsite.live_bytes -= allocation.size_bytes;
+
+	if (allocation.allocator_index >= 0 && allocation.allocator_index < g_max_tracked_allocators)
+	{
+		MemoryAllocatorStats& allocator_stats = g_allocator_stats[allocation.allocator_index];
+		allocator_stats.live_bytes -= allocation.size_bytes;
+	}
+}
+
+static void ProcessEvent(TrackingEvent const& event)
+{
+	bool const valid_allocator = event.allocator_index >= 0 && event.allocator_index < g_max_tracked_allocators;
+	switch (event.type)
+	{
+		case TrackingEventType::Alloc:
+		{
+			S32 const callsite_index = FindOrAddCallsite(event.src);
+			MemoryCallsiteStats& callsite = g_callsites[callsite_index];
+			callsite.allocation_count++;
+			callsite.total_bytes += event.size_bytes;
+			callsite.live_bytes += event.size_bytes;
+			callsite.peak_live_bytes = callsite.live_bytes > callsite.peak_live_bytes ? callsite.live_bytes : callsite.peak_live_bytes;
+
+			if (valid_allocator)
+			{
+				MemoryAllocatorStats& allocator_stats = g_allocator_stats[event.allocator_index];
+				allocator_stats.allocator_index = event.allocator_index;
+				allocator_stats.allocation_count++;
+				allocator_stats.live_bytes += event.size_bytes;
+				allocator_stats.peak_live_bytes = allocator_stats.live_bytes > allocator_stats.peak_live_bytes ? allocator_stats.live_bytes : allocator_stats.peak_live_bytes;
+
+				LiveAllocation const allocation{
+					.ptr = event.ptr,
+					.size_bytes = event.size_bytes,
+					.callsite_index = callsite_index,
+					.allocator_index = event.allocator_index,
+				};
+				InsertLiveAllocation(g_live_allocations[event.allocator_index], allocation);
+			}
+		}
+		break;
+
+		case TrackingEventType::Free:
+		{
+			S32 const slot_index = valid_allocator ? FindLiveAllocation(g_live_allocations[event.allocator_index], event.ptr) : g_null_index;
+			if (slot_index == g_null_index)
+			{
+				g_untracked_free_count++;
+				break;
+			}
+
+			LiveAllocationTable& table = g_live_allocations[event.allocator_index];
+			ReleaseLiveAllocation(table.slots[slot_index]);
+			RemoveLiveAllocationAt(table, slot_index);
+		}
+		break;
+
+		case TrackingEventType::ReleaseRange:
+		{
+			if (valid_allocator)
+			{
+				ReleaseLiveAllocationsInRange(g_live_allocations[event.allocator_index], event.ptr, event.ptr + event.size_bytes);
+			}
+		}
+		break;
+
+		case TrackingEventType::Pages:
+		{
+			if (valid_allocator)
+			{
+				MemoryAllocatorStats& allocator_stats = g_allocator_stats[event.allocator_index];
+				allocator_stats.allocator_index = event.allocator_index;
+				allocator_stats.page_bytes = event.size_bytes;
+				allocator_stats.peak_page_bytes = event.size_bytes > allocator_stats.peak_page_bytes ? event.size_bytes : allocator_stats.peak_page_bytes;
+			}
+		}
+		break;
+
+		case TrackingEventType::Commit:
+		{
+			if (valid_allocator)
+			{
+				MemoryAllocatorStats& allocator_stats = g_allocator_stats[event.allocator_index];
+				allocator_stats.allocator_index = event.allocator_index;
+				allocator_stats.committed_bytes = event.size_bytes;
+				allocator_stats.peak_committed_bytes = event.size_bytes > allocator_stats.peak_committed_bytes ? event.size_bytes : allocator_stats.peak_committed_bytes;
+			}
+		}
+		break;
+
+		case TrackingEventType::AllocatorDestroyed:
+		{
+			// The slot gets reused by the next allocator, which should start from a clean slate. Whatever it still had live
+			// went away with it.
+			if (valid_allocator)
+			{
+				LiveAllocationTable& table = g_live_allocations[event.allocator_index];
+				for (LiveAllocation& allocation : table.slots)
+				{
+					if (allocation.ptr != nullptr)
+					{
+						ReleaseLiveAllocation(allocation);
+						allocation = {};
+					}
+				}
+				table.count = 0;
+				g_allocator_stats[event.allocator_index] = {};
+			}
+		}
+		break;
+	}
+}
+
+static void ApplyPendingEvents(bool collect_all);
+
+// Each thread appends to its own buffer without taking a lock and publishes the count with a release store, so whoever
+// holds g_tracking_mutex can copy the published events while the owner keeps appending behind them. Only the owner
+// resets its buffer, under g_tracking_mutex, when it fills up or the thread exits. That flush only hands over the owner's
+// own events, other threads' buffers are collected by MemoryTrackingFlush.
+class ThreadEventBuffer
+{
+public:
+	ThreadEventBuffer()
+	{
+		std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+		next = g_first_thread_event_buffer;
+		if (next != nullptr)
+		{
+			next->prev = this;
+		}
+		g_first_thread_event_buffer = this;
+	}
+
+	~ThreadEventBuffer()
+	{
+		g_inside_tracker = true;
+		{
+			std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+			Collect();
+			if (prev != nullptr)
+			{
+				prev->next = next;
+			}
+			else
+			{
+				g_first_thread_event_buffer = next;
+			}
+			if (next != nullptr)
+			{
+				next->prev = prev;
+			}
+			ApplyPendingEvents(false);
+		}
+		g_inside_tracker = false;
+	}
+
+	void Push(TrackingEvent event)
+	{
+		S32 event_index = event_count.load(std::memory_order_relaxed);
+		if (event_index == max_event_count)
+		{
+			Flush();
+			event_index = 0;
+		}
+
+		// Nothing from this sequence on can be applied until the event is published. The sequence taken next is always
+		// past the last one this thread took, so that works as a lower bound without reading the shared counter.
+		reserved_sequence.store(min_next_sequence, std::memory_order_release);
+		event.sequence = g_next_event_sequence.fetch_add(1, std::memory_order_release);
+		events[event_index] = event;
+		event_count.store(event_index + 1, std::memory_order_release);
+		reserved_sequence.store(g_no_sequence, std::memory_order_release);
+		min_next_sequence = event.sequence + 1;
+	}
+
+	// Only call with g_tracking_mutex held. Moves the events published since the last collect into the pending list and
+	// returns the lowest sequence this buffer might still hand over later.
+	U64 Collect();
+	// Only call with g_tracking_mutex held. Same as Collect but leaves the events in the buffer.
+	U64 GetMinUncollectedSequence() const;
+	// Only call with g_tracking_mutex held. Drops the published events without applying them.
+	void Discard();
+
+	// Registry of every thread's buffer, only touched under g_tracking_mutex
+	static ThreadEventBuffer* g_first_thread_event_buffer;
+	ThreadEventBuffer* prev = nullptr;
+	ThreadEventBuffer* next = nullptr;
+
+private:
+	static constexpr S32 max_event_count = 256;
+
+	void Flush();
+
+	TrackingEvent events[max_event_count];
+	// Written by the owner only, read under g_tracking_mutex
+	std::atomic<S32> event_count = 0;
+	std::atomic<U64> reserved_sequence = g_no_sequence;
+	// Events below this index have been copied to the pending list, only touched under g_tracking_mutex
+	S32 collected_count = 0;
+	U64 min_next_sequence = 0;
+};
+
+ThreadEventBuffer* ThreadEventBuffer::g_first_thread_event_buffer = nullptr;
+
+U64 ThreadEventBuffer::Collect()
+{
+	// Reserved first, if it reads as free any event this thread took a sequence for before it is in the published count
+	U64 const min_sequence = reserved_sequence.load(std::memory_order_acquire);
+	S32 const published_count = event_count.load(std::memory_order_acquire);
+	S32 const new_count = published_count - collected_count;
+	if (new_count == 0)
+	{
+		return min_sequence;
+	}
+
+	if (g_pending_event_count + new_count > g_pending_events.count)
+	{
+		// The old array stays behind in the arena, the waste is bounded by the geometric growth
+		S32 new_capacity = g_pending_events.count > 0 ? g_pending_events.count : max_event_count;
+		while (new_capacity < g_pending_event_count + new_count)
+		{
+			new_capacity *= 2;
+		}
+		Slice<TrackingEvent> const new_events = AllocTrackingSlice<TrackingEvent>(new_capacity);
+		if (g_pending_event_count > 0)
+		{
+			std::memcpy(new_events.items, g_pending_events.items, sizeof(TrackingEvent) * static_cast<PtrSize>(g_pending_event_count));
+		}
+		g_pending_events = new_events;
+	}
+
+	std::memcpy(g_pending_events.items + g_pending_event_count, events + collected_count, sizeof(TrackingEvent) * static_cast<PtrSize>(new_count));
+	g_pending_event_count += new_count;
+	collected_count = published_count;
+	return min_sequence;
+}
+
+U64 ThreadEventBuffer::GetMinUncollectedSequence() const
+{
+	U64 const min_sequence = reserved_sequence.load(std::memory_order_acquire);
+	S32 const published_count = event_count.load(std::memory_order_acquire);
+	if (published_count > collected_count && events[collected_count].sequence < min_sequence)
+	{
+		return events[collected_count].sequence;
+	}
+	return min_sequence;
+}
+
+void ThreadEventBuffer::Discard()
+{
+	collected_count = event_count.load(std::memory_order_acquire);
+}
+
+void ThreadEventBuffer::Flush()
+{
+	g_inside_tracker = true;
+	{
+		std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+		Collect();
+		event_count.store(0, std::memory_order_relaxed);
+		collected_count = 0;
+		ApplyPendingEvents(false);
+	}
+	g_inside_tracker = false;
+}
+
+static thread_local ThreadEventBuffer g_thread_events;
+
+// Only call with g_tracking_mutex held. An event can only be applied once nothing that happened before it can still
+// turn up, so the pending events stop at the lowest sequence any thread still has buffered or is about to publish.
+static void ApplyPendingEvents(bool collect_all)
+{
+	// Loaded before looking at the buffers, every event below it has either been published or shows up as reserved
+	U64 min_sequence = g_next_event_sequence.load(std::memory_order_acquire);
+	for (ThreadEventBuffer* buffer = ThreadEventBuffer::g_first_thread_event_buffer; buffer != nullptr; buffer = buffer->next)
+	{
+		U64 const buffer_min_sequence = collect_all ? buffer->Collect() : buffer->GetMinUncollectedSequence();
+		min_sequence = buffer_min_sequence < min_sequence ? buffer_min_sequence : min_sequence;
+	}
+
+	// Whatever was left pending last time is already sorted and comes first, so this is mostly in order already
+	std::sort(g_pending_events.items, g_pending_events.items + g_pending_event_count, [](TrackingEvent const& a, TrackingEvent const& b)
+	{
+		return a.sequence < b.sequence;
+	});
+
+	S32 applied_count = 0;
+	while (applied_count < g_pending_event_count && g_pending_events[applied_count].sequence < min_sequence)
+	{
+		ProcessEvent(g_pending_events[applied_count]);
+		applied_count++;
+	}
+
+	g_pending_event_count -= applied_count;
+	if (applied_count > 0 && g_pending_event_count > 0)
+	{
+		std::memmove(g_pending_events.items, g_pending_events.items + applied_count, sizeof(TrackingEvent) * static_cast<PtrSize>(g_pending_event_count));
+	}
+}
+
+static void PushEvent(TrackingEvent const& event)
+{
+	if (g_inside_tracker)
+	{
+		return;
+	}
+	g_thread_events.Push(event);
+}
+
+void MemoryTrackingRecordAlloc(MemorySlice memory, IAllocator* allocator, SrcLocation src)
+{
+	PushEvent({
+		.type = TrackingEventType::Alloc,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = memory.ptr,
+		.size_bytes = memory.size_bytes,
+		.src = src,
+	});
+}
+
+void MemoryTrackingRecordFree(MemorySlice memory, IAllocator* allocator, SrcLocation src)
+{
+	PushEvent({
+		.type = TrackingEventType::Free,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = memory.ptr,
+		.size_bytes = memory.size_bytes,
+		.src = src,
+	});
+}
+
+void MemoryTrackingRecordReleaseRange(MemorySlice range, IAllocator* allocator)
+{
+	if (allocator == &GetTrackingAllocator())
+	{
+		return;
+	}
+
+	PushEvent({
+		.type = TrackingEventType::ReleaseRange,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = range.ptr,
+		.size_bytes = range.size_bytes,
+		.src = SrcLoc(),
+	});
+}
+
+void MemoryTrackingRecordPages(IAllocator* allocator, PtrSize page_bytes)
+{
+	PushEvent({
+		.type = TrackingEventType::Pages,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = nullptr,
+		.size_bytes = page_bytes,
+		.src = SrcLoc(),
+	});
+}
+
+void MemoryTrackingRecordCommit(IAllocator* allocator, PtrSize committed_bytes)
+{
+	PushEvent({
+		.type = TrackingEventType::Commit,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = nullptr,
+		.size_bytes = committed_bytes,
+		.src = SrcLoc(),
+	});
+}
+
+void MemoryTrackingRecordAllocatorDestroyed(IAllocator* allocator)
+{
+	PushEvent({
+		.type = TrackingEventType::AllocatorDestroyed,
+		.allocator_index = allocator->GetAllocatorIndex(),
+		.ptr = nullptr,
+		.size_bytes = 0,
+		.src = SrcLoc(),
+	});
+}
+
+void MemoryTrackingStart()
+{
+	// Construct the tracker's allocator up front, rather than from inside a flush
+	GetTrackingAllocator();
+	g_memory_tracking_running.store(true, std::memory_order_relaxed);
+}
+
+void MemoryTrackingStop()
+{
+	g_memory_tracking_running.store(false, std::memory_order_relaxed);
+	MemoryTrackingFlush();
+}
+
+bool MemoryTrackingIsRunning()
+{
+	return IsMemoryTrackingRunning();
+}
+
+void MemoryTrackingReset()
+{
+	g_inside_tracker = true;
+	{
+		std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+		for (ThreadEventBuffer* buffer = ThreadEventBuffer::g_first_thread_event_buffer; buffer != nullptr; buffer = buffer->next)
+		{
+			buffer->Discard();
+		}
+		g_callsites = {};
+		g_callsite_count = 0;
+		g_callsite_lookup = {};
+		for (LiveAllocationTable& table : g_live_allocations)
+		{
+			table = {};
+		}
+		for (MemoryAllocatorStats& stats : g_allocator_stats)
+		{
+			stats = {};
+		}
+		g_untracked_free_count = 0;
+		g_overwritten_allocation_count = 0;
+		g_pending_events = {};
+		g_pending_event_count = 0;
+		GetTrackingAllocator().FreeAll();
+	}
+	g_inside_tracker = false;
+}
+
+void MemoryTrackingFlush()
+{
+	g_inside_tracker = true;
+	{
+		std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+		ApplyPendingEvents(true);
+	}
+	g_inside_tracker = false;
+}
+
+Slice<MemoryCallsiteStats> MemoryTrackingGetCallsites(IAllocator* allocator)
+{
+	MemoryTrackingFlush();
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+	MemorySlice const memory = AllocMem(sizeof(MemoryCallsiteStats) * static_cast<PtrSize>(g_callsite_count), alignof(MemoryCallsiteStats), allocator, SrcLoc());
+	Slice<MemoryCallsiteStats> const result{reinterpret_cast<MemoryCallsiteStats*>(memory.ptr), g_callsite_count};
+	for (S32 i = 0; i < g_callsite_count; i++)
+	{
+		new (&result[i]) MemoryCallsiteStats(g_callsites[i]);
+	}
+	return result;
+}
+
+Slice<MemoryAllocatorStats> MemoryTrackingGetAllocators(IAllocator* allocator)
+{
+	MemoryTrackingFlush();
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+	S32 count = 0;
+	for (MemoryAllocatorStats const& stats : g_allocator_stats)
+	{
+		count += stats.allocator_index != g_null_index;
+	}
+
+	MemorySlice const memory = AllocMem(sizeof(MemoryAllocatorStats) * static_cast<PtrSize>(count), alignof(MemoryAllocatorStats), allocator, SrcLoc());
+	Slice<MemoryAllocatorStats> const result{reinterpret_cast<MemoryAllocatorStats*>(memory.ptr), count};
+	S32 write_index = 0;
+	for (MemoryAllocatorStats const& stats : g_allocator_stats)
+	{
+		if (stats.allocator_index != g_null_index)
+		{
+			new (&result[write_index++]) MemoryAllocatorStats(stats);
+		}
+	}
+	return result;
+}
+
+U64 MemoryTrackingGetUntrackedFreeCount()
+{
+	MemoryTrackingFlush();
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+	return g_untracked_free_count;
+}
+
+U64 MemoryTrackingGetOverwrittenAllocationCount()
+{
+	MemoryTrackingFlush();
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+	return g_overwritten_allocation_count;
+}
+
+static void WriteJsonString(FILE* file, char const* str)
+{
+	std::fputc('"', file);
+	for (char const* c = str; c && *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			std::fputc('\\', file);
+		}
+		std::fputc(*c, file);
+	}
+	std::fputc('"', file);
+}
+
+bool MemoryTrackingWriteJson(char const* path)
+{
+	MemoryTrackingFlush();
+
+	FILE* const file = std::fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+
+	std::fprintf(file, "{\n\t\"untracked_free_count\": %llu,\n\t\"overwritten_allocation_count\": %llu,\n\t\"callsites\": [\n", g_untracked_free_count, g_overwritten_allocation_count);
+	for (S32 i = 0; i < g_callsite_count; i++)
+	{
+		MemoryCallsiteStats const& callsite = g_callsites[i];
+		std::fprintf(file, "\t\t{\"file\": ");
+		WriteJsonString(file, callsite.src.file);
+		std::fprintf(file, ", \"function\": ");
+		WriteJsonString(file, callsite.src.function);
+		std::fprintf(
+			file,
+			", \"line\": %d, \"column\": %d, \"allocation_count\": %llu, \"free_count\": %llu, \"total_bytes\": %llu, \"live_bytes\": %llu, \"peak_live_bytes\": %llu}%s\n",
+			callsite.src.line,
+			callsite.src.column,
+			callsite.allocation_count,
+			callsite.free_count,
+			callsite.total_bytes,
+			callsite.live_bytes,
+			callsite.peak_live_bytes,
+			i < g_callsite_count - 1 ? "," : "");
+	}
+	std::fprintf(file, "\t],\n\t\"allocators\": [\n");
+
+	bool first = true;
+	for (MemoryAllocatorStats const& stats : g_allocator_stats)
+	{
+		if (stats.allocator_index == g_null_index)
+		{
+			continue;
+		}
+
+		std::fprintf(
+			file,
+			"%s\t\t{\"allocator_index\": %d, \"allocation_count\": %llu, \"live_bytes\": %llu, \"peak_live_bytes\": %llu, \"page_bytes\": %llu, \"peak_page_bytes\": %llu, \"committed_bytes\": %llu, \"peak_committed_bytes\": %llu}",
+			first ? "" : ",\n",
+			stats.allocator_index,
+			stats.allocation_count,
+			stats.live_bytes,
+			stats.peak_live_bytes,
+			stats.page_bytes,
+			stats.peak_page_bytes,
+			stats.committed_bytes,
+			stats.peak_committed_bytes);
+		first = false;
+	}
+	std::fprintf(file, "\n\t]\n}\n");
+
+	std::fclose(file);
+	return true;
+}
+
+bool MemoryTrackingWriteCallsitesCsv(char const* path)
+{
+	MemoryTrackingFlush();
+
+	FILE* const file = std::fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+
+	std::fprintf(file, "file,function,line,column,allocation_count,free_count,total_bytes,live_bytes,peak_live_bytes\n");
+	for (S32 i = 0; i < g_callsite_count; i++)
+	{
+		MemoryCallsiteStats const& callsite = g_callsites[i];
+		std::fprintf(
+			file,
+			"\"%s\",\"%s\",%d,%d,%llu,%llu,%llu,%llu,%llu\n",
+			callsite.src.file,
+			callsite.src.function,
+			callsite.src.line,
+			callsite.src.column,
+			callsite.allocation_count,
+			callsite.free_count,
+			callsite.total_bytes,
+			callsite.live_bytes,
+			callsite.peak_live_bytes);
+	}
+
+	std::fclose(file);
+	return true;
+}
+
+bool MemoryTrackingWriteAllocatorsCsv(char const* path)
+{
+	MemoryTrackingFlush();
+
+	FILE* const file = std::fopen(path, "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> const lock(g_tracking_mutex);
+
+	std::fprintf(file, "allocator_index,allocation_count,live_bytes,peak_live_bytes,page_bytes,peak_page_bytes,committed_bytes,peak_committed_bytes\n");
+	for (MemoryAllocatorStats const& stats : g_allocator_stats)
+	{
+		if (stats.allocator_index == g_null_index)
+		{
+			continue;
+		}
+
+		std::fprintf(
+			file,
+			"%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+			stats.allocator_index,
+			stats.allocation_count,
+			stats.live_bytes,
+			stats.peak_live_bytes,
+			stats.page_bytes,
+			stats.peak_page_bytes,
+			stats.committed_bytes,
+			stats.peak_committed_bytes);
+	}
+
+	std::fclose(file);
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <core/memory_types.h>
+#include <core/src_location_types.h>
+
+#include <atomic>
+
+#if !defined(PAW_RETAIL)
+#define PAW_MEMORY_TRACKING 1
+#else
+#define PAW_MEMORY_TRACKING 0
+#endif
+
+extern std::atomic<bool> g_memory_tracking_running;
+
+inline bool IsMemoryTrackingRunning()
+{
+	return PAW_MEMORY_TRACKING && g_memory_tracking_running.load(std::memory_order_relaxed);
+}
+
+// Hooks for the allocators. Only call these when IsMemoryTrackingRunning() is true.
+void MemoryTrackingRecordAlloc(MemorySlice memory, IAllocator* allocator, SrcLocation src);
+void MemoryTrackingRecordFree(MemorySlice memory, IAllocator* allocator, SrcLocation src);
+// Everything still live inside the range is dropped, for arena resets that never call Free per allocation
+void MemoryTrackingRecordReleaseRange(MemorySlice range, IAllocator* allocator);
+// Pages in use after AllocPages/FreePages, committed bytes after the OS commit changed
+void MemoryTrackingRecordPages(IAllocator* allocator, PtrSize page_bytes);
+void MemoryTrackingRecordCommit(IAllocator* allocator, PtrSize committed_bytes);
+void MemoryTrackingRecordAllocatorDestroyed(IAllocator* allocator);
@@ -0,0 +1,50 @@
+#include <core/platform.h>
+
+#include <core/assert.h>
+#include <core/memory.h>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wmicrosoft-enum-value"
+#include <Windows.h>
+#pragma clang diagnostic pop
+
+Byte* PlatformReserveAddressSpace(PtrSize size_bytes)
+{
+	void* const address_space = VirtualAlloc2(nullptr, nullptr, size_bytes, MEM_RESERVE, PAGE_NOACCESS, nullptr, 0);
+	Byte* const result = reinterpret_cast<Byte*>(address_space);
+	return result;
+}
+
+// Large pages on Windows have to be reserved and committed in one call with SeLockMemoryPrivilege, so they can't be
+// committed into the existing reservation. Huge page modes still commit at 2 MiB granularity but use normal pages.
+void PlatformCommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 flags)
+{
+	VirtualAlloc(start_ptr, size_bytes, MEM_COMMIT, PAGE_READWRITE);
+
+	if ((flags & PlatformCommitFlags_Prefault) != 0)
+	{
+		for (PtrSize offset = 0; offset < size_bytes; offset += KiloBytes(4))
+		{
+			Byte volatile* const ptr = start_ptr + offset;
+			*ptr = *ptr;
+		}
+	}
+}
+
+void PlatformDecommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 /*flags*/)
+{
+	VirtualFree(start_ptr, size_bytes, MEM_DECOMMIT);
+}
+
+// The pages stay committed and keep counting against the commit charge, only the working set shrinks
+void PlatformPurgeAddressSpace(Byte* start_ptr, PtrSize size_bytes)
+{
+	if (size_bytes == 0)
+	{
+		return;
+	}
+
+	DWORD const result = DiscardVirtualMemory(start_ptr, size_bytes);
+	PAW_ASSERT(result == ERROR_SUCCESS, "Failed to purge address space");
+	PAW_UNUSED_ARG(result);
+}
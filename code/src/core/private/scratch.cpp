@@ -0,0 +1,47 @@
+#include <core/memory.h>
+#include <core/scratch.h>
+
+struct ScratchArenas
+{
+	ScratchArenas()
+	{
+		for (ArenaAllocator& arena : arenas)
+		{
+			arena.SetMemoryCategory(MemoryCategory::Temp);
+			arena.SetRetentionPolicy({.keep_committed_bytes = ScratchScope::keep_committed_bytes});
+		}
+	}
+
+	ArenaAllocator arenas[2];
+	S32 open_scope_counts[2]{};
+};
+
+static ScratchArenas& GetThreadScratchArenas()
+{
+	// Function local so threads that never use scratch memory don't take up allocator slots
+	static thread_local ScratchArenas scratch_arenas;
+	return scratch_arenas;
+}
+
+ScratchScope::ScratchScope(IAllocator* conflict)
+{
+	ScratchArenas& scratch_arenas = GetThreadScratchArenas();
+	arena_index = &scratch_arenas.arenas[0] == conflict ? 1 : 0;
+	arena = &scratch_arenas.arenas[arena_index];
+	marker = arena->GetMarker();
+	scratch_arenas.open_scope_counts[arena_index]++;
+}
+
+ScratchScope::~ScratchScope()
+{
+	// Nested scopes leave the pages for the next allocations, the outermost one hands back whatever went past
+	// keep_committed_bytes so one unusually big temporary doesn't stay committed on this thread forever
+	S32& open_scope_count = GetThreadScratchArenas().open_scope_counts[arena_index];
+	open_scope_count--;
+	arena->FreeToMarker(marker, open_scope_count == 0);
+}
+
+ArenaAllocator* ScratchScope::GetAllocator() const
+{
+	return arena;
+}
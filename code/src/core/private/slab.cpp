@@ -0,0 +1,94 @@
+#include <core/slab.h>
+
+#include <core/assert.h>
+
+#include <bit>
+#include <new>
+
+static PtrSize CalcSlotStride(PtrSize slot_size_bytes, PtrSize slot_alignment)
+{
+	PtrSize stride_bytes = slot_size_bytes > sizeof(void*) ? slot_size_bytes : sizeof(void*);
+	stride_bytes = stride_bytes > slot_alignment ? stride_bytes : slot_alignment;
+	if (stride_bytes <= SlabAllocator::cache_line_size)
+	{
+		return std::bit_ceil(stride_bytes);
+	}
+
+	// Starting every slot on a line would waste up to a line per slot
+	return AlignSizeForward(stride_bytes, slot_alignment);
+}
+
+SlabAllocator::SlabAllocator(PtrSize slot_size_bytes, PtrSize slot_alignment, PageConfig page_config)
+	: IAllocator(page_config)
+	, slot_stride_Bytes(CalcSlotStride(slot_size_bytes, slot_alignment))
+	// The pages start page aligned, so power of two strides are aligned to themselves
+	, slot_alignment_bytes(slot_stride_Bytes <= cache_line_size ? slot_stride_Bytes : slot_alignment)
+{
+	PAW_ASSERT(std::has_single_bit(slot_alignment), "Slot alignment has to be a power of two");
+}
+
+SlabAllocator::~SlabAllocator()
+{
+}
+
+MemorySlice SlabAllocator::Alloc(PtrSize size_Bytes, PtrSize alignment)
+{
+	PAW_ASSERT(size_Bytes <= slot_stride_Bytes && alignment <= slot_alignment_bytes, "Allocation doesn't fit in a slot");
+	if (size_Bytes > slot_stride_Bytes || alignment > slot_alignment_bytes)
+	{
+		return {};
+	}
+
+	if (free_list)
+	{
+		FreeSlot* const slot = free_list;
+		free_list = slot->next;
+		live_slot_count++;
+		return {reinterpret_cast<Byte*>(slot), size_Bytes};
+	}
+
+	PtrSize const memory_size_Bytes = CalcMemorySizeBytes();
+	if (carved_Bytes + slot_stride_Bytes > memory_size_Bytes)
+	{
+		if (!AllocPages(CalcPageCountFromSize(carved_Bytes + slot_stride_Bytes - memory_size_Bytes)))
+		{
+			return {};
+		}
+	}
+
+	Byte* const slot = GetBaseAddress() + carved_Bytes;
+	carved_Bytes += slot_stride_Bytes;
+	live_slot_count++;
+	return {slot, size_Bytes};
+}
+
+void SlabAllocator::Free(MemorySlice memory)
+{
+	PAW_ASSERT(memory.ptr >= GetBaseAddress() && memory.ptr < GetBaseAddress() + carved_Bytes, "Memory wasn't allocated from this slab");
+
+	free_list = new (memory.ptr) FreeSlot{free_list};
+	live_slot_count--;
+}
+
+bool SlabAllocator::TryResize(MemorySlice /*memory*/, PtrSize new_size_bytes)
+{
+	return new_size_bytes <= slot_stride_Bytes;
+}
+
+void SlabAllocator::FreeAll()
+{
+	FreeAllPages();
+	free_list = nullptr;
+	carved_Bytes = 0;
+	live_slot_count = 0;
+}
+
+PtrSize SlabAllocator::GetSlotStrideBytes() const
+{
+	return slot_stride_Bytes;
+}
+
+S32 SlabAllocator::GetLiveSlotCount() const
+{
+	return live_slot_count;
+}
@@ -0,0 +1,145 @@
+#include <core/arena.h>
+#include <core/assert.h>
+#include <core/logger.h>
+#include <core/string_id.h>
+
+#include "string_id_internal.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+
+// Open addressed table of entry pointers. Entries are only ever added, so inserting is a CAS on an empty slot and
+// lookups never need a lock. The id decides the home slot, collisions between ids probe linearly.
+static constexpr S32 g_string_id_slot_count = 1 << 16;
+static constexpr S32 g_string_id_max_count = g_string_id_slot_count / 8 * 7;
+
+struct StringIdEntry
+{
+	U32 id;
+	U32 size_bytes;
+	// Followed by the string bytes and a null terminator
+};
+
+static std::atomic<StringIdEntry*> g_string_id_slots[g_string_id_slot_count]{};
+static std::atomic<S32> g_string_id_count = 0;
+
+// Made by StringIdInit and never destroyed, interned strings have to outlive every other static that holds a StringId
+alignas(ConcurrentArenaAllocator) static Byte g_string_id_allocator_storage[sizeof(ConcurrentArenaAllocator)];
+static ConcurrentArenaAllocator* g_string_id_allocator = nullptr;
+
+void StringIdInit()
+{
+	PAW_ASSERT(g_string_id_allocator == nullptr, "StringIdInit is called once by MemoryInit");
+	g_string_id_allocator = new (g_string_id_allocator_storage) ConcurrentArenaAllocator();
+}
+
+static StringView8 GetEntryString(StringIdEntry const* entry)
+{
+	return {.ptr = reinterpret_cast<Byte const*>(entry + 1), .size_bytes = entry->size_bytes};
+}
+
+static bool EntryEquals(StringIdEntry const* entry, StringView8 str)
+{
+	return entry->size_bytes == str.size_bytes && std::memcmp(entry + 1, str.ptr, str.size_bytes) == 0;
+}
+
+static StringIdEntry* CreateEntry(U32 id, StringView8 str)
+{
+	MemorySlice const memory = g_string_id_allocator->Alloc(sizeof(StringIdEntry) + str.size_bytes + 1, alignof(StringIdEntry));
+	if (memory.ptr == nullptr)
+	{
+		return nullptr;
+	}
+
+	StringIdEntry* const entry = reinterpret_cast<StringIdEntry*>(memory.ptr);
+	entry->id = id;
+	entry->size_bytes = static_cast<U32>(str.size_bytes);
+	Byte* const bytes = reinterpret_cast<Byte*>(entry + 1);
+	std::memcpy(bytes, str.ptr, str.size_bytes);
+	bytes[str.size_bytes] = 0;
+	return entry;
+}
+
+StringId StringIdIntern(StringView8 str)
+{
+	U32 const id = StringIdFoldHash(Hash64(str), str.size_bytes);
+	if (id == 0)
+	{
+		return {};
+	}
+
+	// A PAW_SID in a static initializer runs before main. The id is right either way, the string just can't be looked up.
+	PAW_ASSERT(g_string_id_allocator != nullptr, "StringIdIntern called before MemoryInit");
+	if (g_string_id_allocator == nullptr)
+	{
+		return {id};
+	}
+
+	StringIdEntry* new_entry = nullptr;
+	U32 slot_index = id & (g_string_id_slot_count - 1);
+	for (S32 probe_count = 0; probe_count < g_string_id_slot_count; probe_count++, slot_index = (slot_index + 1) & (g_string_id_slot_count - 1))
+	{
+		StringIdEntry* entry = g_string_id_slots[slot_index].load(std::memory_order_acquire);
+		if (entry == nullptr)
+		{
+			// Made once and reused if another thread takes the slot first, it stays unused in the arena if the string turns up
+			if (new_entry == nullptr)
+			{
+				new_entry = CreateEntry(id, str);
+			}
+			if (new_entry == nullptr)
+			{
+				break;
+			}
+			if (g_string_id_slots[slot_index].compare_exchange_strong(entry, new_entry, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				S32 const count = g_string_id_count.fetch_add(1, std::memory_order_relaxed) + 1;
+				PAW_ASSERT(count <= g_string_id_max_count, "Too many interned strings, increase g_string_id_slot_count");
+				PAW_UNUSED_ARG(count);
+				return {id};
+			}
+			// entry now holds whatever the other thread stored, check it like any other occupied slot
+		}
+
+		if (entry->id == id)
+		{
+			PAW_ASSERT(EntryEquals(entry, str), "Two different strings hash to the same StringId");
+			return {id};
+		}
+	}
+
+	// Every slot is taken or the arena is out of memory. Still loud in release, the id works but the string is lost.
+	PAW_ASSERT(false, "Too many interned strings, increase g_string_id_slot_count");
+	PAW_ERROR("Couldn't intern \"%.*s\", StringIdGetString won't find it", static_cast<S32>(str.size_bytes), reinterpret_cast<char const*>(str.ptr));
+	return {id};
+}
+
+StringView8 StringIdGetString(StringId id)
+{
+	if (id.value == 0)
+	{
+		return PAW_STR("");
+	}
+
+	U32 slot_index = id.value & (g_string_id_slot_count - 1);
+	for (S32 probe_count = 0; probe_count < g_string_id_slot_count; probe_count++, slot_index = (slot_index + 1) & (g_string_id_slot_count - 1))
+	{
+		StringIdEntry const* const entry = g_string_id_slots[slot_index].load(std::memory_order_acquire);
+		if (entry == nullptr)
+		{
+			break;
+		}
+		if (entry->id == id.value)
+		{
+			return GetEntryString(entry);
+		}
+	}
+
+	return PAW_STR("<unknown StringId>");
+}
+
+S32 StringIdGetCount()
+{
+	return g_string_id_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Called by MemoryInit once the address space is reserved, the interned strings live in an allocator of their own
+void StringIdInit();
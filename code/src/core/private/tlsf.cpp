@@ -3,14 +3,17 @@
 #include <core/math.h>
 #include <core/memory.inl>
 
+#include <bit>
 #include <new>
-#include <cstdio>
+#include <cstring>
+#include <thread>
 
 enum BlockFlags
 {
 	BlockFlags_None,
 	BlockFlags_Free = 1 << 0,
-	// BlockFlags_LastPhysical = 1 << 1,
+	// Every whole page behind the FreeBlock header was purged, see TLSFAllocator::ReleaseFreePages
+	BlockFlags_Purged = 1 << 1,
 };
 
 struct BlockInfo
@@ -38,7 +41,12 @@ struct BlockInfo
 
 	void SetUsed()
 	{
-		data = data & ~(BlockFlags_Free);
+		data = data & ~(BlockFlags_Free | BlockFlags_Purged);
+	}
+
+	void SetPurged()
+	{
+		data = data | BlockFlags_Purged;
 	}
 
 	// void SetNotLastPhysical()
@@ -61,6 +69,11 @@ struct BlockInfo
 		return (data & BlockFlags_Free) == BlockFlags_Free;
 	}
 
+	bool IsPurged() const
+	{
+		return (data & BlockFlags_Purged) == BlockFlags_Purged;
+	}
+
 	// bool IsLastPhysical() const
 	//{
 	//	return (data & BlockFlags_LastPhysical) == BlockFlags_LastPhysical;
@@ -100,23 +113,50 @@ struct UsedBlock : TLSFAllocator::CommonBlock
 	}
 };
 
+static_assert(sizeof(UsedBlock) == 16, "The padding byte lookup relies on the header ending in prev_physical_block");
+static_assert(std::endian::native == std::endian::little, "The padding byte lookup relies on the header ending in the top byte of prev_physical_block");
+
 struct Index
 {
 	S32 top_level;
 	S32 second_level;
 };
 
+// Blocks below small_block_size bytes share top level 0 in linear size classes of block_granularity bytes. Anything
+// bigger uses the usual log2 top levels, which start at 8 so levels 1 to 7 are never used.
+static constexpr PtrSize block_granularity = 16;
+static constexpr PtrSize small_block_size = 256;
+
 static Index Map(PtrSize size_bytes)
 {
+	if (size_bytes < small_block_size)
+	{
+		return {0, static_cast<S32>(size_bytes / block_granularity)};
+	}
+
 	S32 const top_bin_index = BitScanMSB(size_bytes);
-	S32 const sub_bin_index = ((size_bytes ^ (1 << top_bin_index)) >> (top_bin_index - TLSFAllocator::second_level_index));
+	S32 const sub_bin_index = static_cast<S32>((size_bytes ^ (PtrSize(1) << top_bin_index)) >> (top_bin_index - TLSFAllocator::second_level_index));
 
 	return {top_bin_index, sub_bin_index};
 }
 
-// #TODO: Look into grouping a small amount of buckets at the beginning together
-// https://ricefields.me/2024/04/20/tlsf-allocator.html
-TLSFAllocator::TLSFAllocator()
+static PtrSize CalcSearchRoundUpBytes(PtrSize size_bytes)
+{
+	if (size_bytes < small_block_size)
+	{
+		return block_granularity - 1;
+	}
+	return (PtrSize(1) << (BitScanMSB(size_bytes) - TLSFAllocator::second_level_index)) - 1;
+}
+
+// Rounds the size up to the next sub bin boundary, so any block in the bin it maps to is big enough
+static Index MapSearch(PtrSize size_bytes)
+{
+	return Map(size_bytes + CalcSearchRoundUpBytes(size_bytes));
+}
+
+TLSFAllocator::TLSFAllocator(PageConfig page_config)
+	: IAllocator(page_config)
 {
 }
 
@@ -124,55 +164,73 @@ TLSFAllocator::~TLSFAllocator()
 {
 }
 
+void TLSFAllocator::SetReleasePolicy(TLSFReleasePolicy policy)
+{
+	release_policy = policy;
+}
+
 MemorySlice TLSFAllocator::Alloc(PtrSize size_bytes, PtrSize alignment)
 {
 	PAW_ASSERT(alignment <= 256, "alignment more than 256 bytes is not supported");
 
-	PtrSize const total_size_bytes = size_bytes + sizeof(UsedBlock) + alignment;
-	PAW_ASSERT(total_size_bytes <= GetPageSize(), "TLSF doesn't support allocations greater than platform page size");
-	Index index = Map(total_size_bytes);
+	// Blocks are block_granularity aligned, so data right behind the header is already aligned for anything up to that.
+	// Only over-aligned allocations pay for padding. Every used block has to be able to turn back into a free block.
+	PtrSize const padding_bytes = alignment > block_granularity ? alignment - block_granularity : 0;
+	PtrSize const requested_size_bytes = AlignSizeForward(size_bytes + sizeof(UsedBlock) + padding_bytes, block_granularity);
+	PtrSize const total_size_bytes = requested_size_bytes > sizeof(FreeBlock) ? requested_size_bytes : sizeof(FreeBlock);
+	Index index = MapSearch(total_size_bytes);
 	// Mask out all the bits below the sub bin index
 	U32 sub_bin_bitmap = second_level_bitmaps[index.top_level] & (~0u << index.second_level);
 
 	if (sub_bin_bitmap == 0)
 	{
 		//	Mask out all the bit for the top bin index and all below it
-		U64 bin_bitmap = top_level_bitmap & (~0u << (index.top_level + 1));
+		U64 bin_bitmap = top_level_bitmap & (~0ull << (index.top_level + 1));
 
 		// Out of memory
 		if (bin_bitmap == 0)
 		{
-			Byte* const new_page_ptr = GetBaseAddress() + CalcMemorySizeBytes();
-			AllocPages(1);
-			// #TODO: Change page size here to actual new size if we need to support allocs > page size
-			MemorySlice new_block_memory = {new_page_ptr, GetPageSize()};
+			// The new block has to reach the lower bound of the bin the search looks in, a free block at the end of the
+			// heap gets merged with the new pages so only the difference has to be committed
+			PtrSize const search_round_up_bytes = CalcSearchRoundUpBytes(total_size_bytes);
+			PtrSize const search_size_bytes = (total_size_bytes + search_round_up_bytes) & ~search_round_up_bytes;
+			FreeBlock* const trailing_free_block = last_physical_block && last_physical_block->info.IsFree() ? std::launder(reinterpret_cast<FreeBlock*>(last_physical_block)) : nullptr;
+			PtrSize const trailing_free_bytes = trailing_free_block ? trailing_free_block->info.GetSize() : 0;
+			PtrSize const new_page_count = CalcPageCountFromSize(search_size_bytes - trailing_free_bytes);
+
+			Byte* const new_pages_ptr = GetBaseAddress() + CalcMemorySizeBytes();
+			if (!AllocPages(new_page_count))
+			{
+				return {};
+			}
+
+			MemorySlice new_block_memory = {new_pages_ptr, new_page_count * GetPageSize()};
 			U64 prev_physical_block = 0;
-			if (last_physical_block)
+			if (trailing_free_block)
 			{
-				if (last_physical_block->info.IsFree())
-				{
-					FreeBlock* const free_block = std::launder(reinterpret_cast<FreeBlock*>(last_physical_block));
-					RemoveBlock(free_block);
-					new_block_memory.ptr = reinterpret_cast<Byte*>(free_block);
-					// #TODO: Change page size here to actual new size if we need to support allocs > page size
-					new_block_memory.size_bytes = GetPageSize() + free_block->info.GetSize();
-					prev_physical_block = free_block->prev_physical_block;
-				}
-				else
-				{
-					prev_physical_block = last_physical_block->info.GetSize();
-				}
+				RemoveBlock(trailing_free_block);
+				new_block_memory.ptr = reinterpret_cast<Byte*>(trailing_free_block);
+				new_block_memory.size_bytes += trailing_free_bytes;
+				prev_physical_block = trailing_free_block->prev_physical_block;
+			}
+			else if (last_physical_block)
+			{
+				prev_physical_block = last_physical_block->info.GetSize();
 			}
 			InsertBlock(new_block_memory, prev_physical_block);
 
-			// NOTE(nathan): Don't do the +1 here. We just added new memory which means we could find memory in
-			// a matching bin now
-			bin_bitmap = top_level_bitmap & (~0u << index.top_level);
+			// NOTE(nathan): We just added new memory which means we could find memory in a matching bin now, either
+			// in the requested top level (only from the requested sub bin up) or above it
+			sub_bin_bitmap = second_level_bitmaps[index.top_level] & (~0u << index.second_level);
+			bin_bitmap = top_level_bitmap & (~0ull << (index.top_level + 1));
 		}
 
-		PAW_ASSERT(bin_bitmap != 0, "Viable bin was not found... It should have found one");
-		index.top_level = BitScanLSB(bin_bitmap);
-		sub_bin_bitmap = second_level_bitmaps[index.top_level];
+		if (sub_bin_bitmap == 0)
+		{
+			PAW_ASSERT(bin_bitmap != 0, "Viable bin was not found... It should have found one");
+			index.top_level = BitScanLSB(bin_bitmap);
+			sub_bin_bitmap = second_level_bitmaps[index.top_level];
+		}
 	}
 
 	index.second_level = BitScanLSB(sub_bin_bitmap);
@@ -182,53 +240,76 @@ MemorySlice TLSFAllocator::Alloc(PtrSize size_bytes, PtrSize alignment)
 	PAW_ASSERT(head != nullptr, "Free list should not be nullptr if the bitmap isn't empty");
 	FreeBlock* block = head;
 	head = block->next_free_block;
+	free_bin_block_counts[free_list_index]--;
+	free_block_count--;
+	free_bytes -= block->info.GetSize();
 	if (head == nullptr)
 	{
-		second_level_bitmaps[index.top_level] &= ~(1 << index.second_level);
+		second_level_bitmaps[index.top_level] &= ~(1u << index.second_level);
 		if (second_level_bitmaps[index.top_level] == 0)
 		{
-			top_level_bitmap &= ~(1 << index.top_level);
+			top_level_bitmap &= ~(1ull << index.top_level);
 		}
 	}
+	else
+	{
+		head->prev_free_block = nullptr;
+	}
 
-	PtrSize const aligned_block_size = AlignSizeForward(total_size_bytes, 4);
+	PtrSize const aligned_block_size = total_size_bytes;
 	{
 
-		if (block->info.GetSize() > aligned_block_size + sizeof(FreeBlock))
+		if (block->info.GetSize() >= aligned_block_size + sizeof(FreeBlock))
 		{
 			PtrSize const new_split_size = block->info.GetSize() - aligned_block_size;
 			Byte* const new_split_ptr = reinterpret_cast<Byte*>(block) + aligned_block_size;
+			bool const was_last_physical = block == last_physical_block;
 			block->info.SetSize(aligned_block_size);
 			// block->info.SetNotLastPhysical();
 			InsertBlock({new_split_ptr, new_split_size}, aligned_block_size);
+			if (block->info.IsPurged())
+			{
+				// The remainder's pages are a subset of the ones that were purged, its header sits in front of them
+				std::launder(reinterpret_cast<FreeBlock*>(new_split_ptr))->info.SetPurged();
+			}
+			if (!was_last_physical)
+			{
+				// The block after the split now sits behind the new free block instead of the whole original one
+				CommonBlock* const next_block_common = std::launder(reinterpret_cast<CommonBlock*>(new_split_ptr + new_split_size));
+				next_block_common->prev_physical_block = new_split_size;
+			}
 		}
 	}
 
 	UsedBlock* const used_block = new (block) UsedBlock(*block);
+	used_block_count++;
 
 	Byte* result_ptr = reinterpret_cast<Byte*>(used_block) + sizeof(UsedBlock);
-	PtrSize alignment_offset = CalcAlignmentOffset(result_ptr, alignment);
-	if (alignment_offset == 0)
+	PtrSize const alignment_offset = CalcAlignmentOffset(result_ptr, alignment);
+	if (alignment_offset != 0)
 	{
-		alignment_offset = alignment;
+		result_ptr += alignment_offset;
+		result_ptr[-1] = static_cast<Byte>(alignment_offset);
 	}
-	result_ptr += alignment_offset;
-	result_ptr[-1] = static_cast<Byte>(alignment_offset & 0xFF);
 
 	return {result_ptr, size_bytes};
 }
 
-void TLSFAllocator::Free(MemorySlice in_memory)
+// The byte in front of the data is the padding size when there is padding. Otherwise it's the top byte of the header's
+// prev_physical_block, which is always 0 because no block gets anywhere near 2^56 bytes.
+static Byte* GetUsedBlockAddress(Byte* ptr)
 {
-	PtrDiff shift = in_memory.ptr[-1];
-	if (shift == 0)
-	{
-		shift = 256;
-	}
+	PtrDiff const padding_bytes = ptr[-1];
+	return ptr - padding_bytes - sizeof(UsedBlock);
+}
 
-	Byte* const actual_address = in_memory.ptr - shift;
-	Byte* const block_address = actual_address - sizeof(UsedBlock);
+void TLSFAllocator::Free(MemorySlice in_memory)
+{
+	Byte* const block_address = GetUsedBlockAddress(in_memory.ptr);
 	UsedBlock* block = std::launder(reinterpret_cast<UsedBlock*>(block_address));
+	used_block_count--;
+	Byte* dirty_begin = block_address;
+	Byte* dirty_end = block_address + block->info.GetSize();
 	if (block != last_physical_block)
 	{
 		Byte* const next_block_address = block_address + block->info.GetSize();
@@ -236,6 +317,7 @@ void TLSFAllocator::Free(MemorySlice in_memory)
 		if (next_block_common->info.IsFree())
 		{
 			FreeBlock const* const next_block = std::launder(reinterpret_cast<FreeBlock*>(next_block_address));
+			dirty_end = next_block->info.IsPurged() ? next_block_address + sizeof(FreeBlock) : next_block_address + next_block->info.GetSize();
 			if (next_block == last_physical_block)
 			{
 				// block->info.SetLastPhysical();
@@ -256,6 +338,10 @@ void TLSFAllocator::Free(MemorySlice in_memory)
 	if (prev_block_common->info.IsFree())
 	{
 		FreeBlock* const prev_block = std::launder(reinterpret_cast<FreeBlock*>(prev_block_address));
+		if (!prev_block->info.IsPurged())
+		{
+			dirty_begin = prev_block_address;
+		}
 
 		RemoveBlock(prev_block);
 
@@ -272,18 +358,91 @@ void TLSFAllocator::Free(MemorySlice in_memory)
 			next_block_common->prev_physical_block = new_block_size;
 		}
 		InsertBlock({prev_block_address, new_block_size}, prev_block->prev_physical_block);
+		ReleaseFreePages(std::launder(reinterpret_cast<FreeBlock*>(prev_block_address)), dirty_begin, dirty_end);
 	}
 	else
 	{
 		InsertBlock({block_address, block->info.GetSize()}, block->prev_physical_block);
+		ReleaseFreePages(std::launder(reinterpret_cast<FreeBlock*>(block_address)), dirty_begin, dirty_end);
+	}
+}
+
+bool TLSFAllocator::TryResize(MemorySlice memory, PtrSize new_size_bytes)
+{
+	Byte* const block_address = GetUsedBlockAddress(memory.ptr);
+	CommonBlock* const block = std::launder(reinterpret_cast<CommonBlock*>(block_address));
+
+	PtrSize const data_offset = static_cast<PtrSize>(memory.ptr - block_address);
+	PtrSize const required_size_bytes = AlignSizeForward(data_offset + new_size_bytes, block_granularity);
+	PtrSize const needed_size_bytes = required_size_bytes > sizeof(FreeBlock) ? required_size_bytes : sizeof(FreeBlock);
+	PtrSize block_size = block->info.GetSize();
+
+	if (needed_size_bytes > block_size)
+	{
+		if (block == last_physical_block)
+		{
+			return false;
+		}
+
+		CommonBlock const* const next_block_common = std::launder(reinterpret_cast<CommonBlock*>(block_address + block_size));
+		if (!next_block_common->info.IsFree() || block_size + next_block_common->info.GetSize() < needed_size_bytes)
+		{
+			return false;
+		}
+
+		FreeBlock const* const next_block = std::launder(reinterpret_cast<FreeBlock const*>(next_block_common));
+		bool const next_was_last_physical = next_block_common == last_physical_block;
+		RemoveBlock(next_block);
+
+		block_size += next_block->info.GetSize();
+		block->info.SetSize(block_size);
+		if (next_was_last_physical)
+		{
+			last_physical_block = block;
+		}
+		else
+		{
+			CommonBlock* const following_block = std::launder(reinterpret_cast<CommonBlock*>(block_address + block_size));
+			following_block->prev_physical_block = block_size;
+		}
+	}
+
+	// Hand the tail back when it's big enough to be a block of its own
+	if (block_size - needed_size_bytes >= sizeof(FreeBlock))
+	{
+		Byte* const tail_address = block_address + needed_size_bytes;
+		PtrSize tail_size = block_size - needed_size_bytes;
+		bool const was_last_physical = block == last_physical_block;
+		block->info.SetSize(needed_size_bytes);
+
+		if (!was_last_physical)
+		{
+			// Only possible when shrinking, a free block right behind the tail gets merged into it
+			CommonBlock const* const following_block_common = std::launder(reinterpret_cast<CommonBlock*>(tail_address + tail_size));
+			if (following_block_common->info.IsFree())
+			{
+				RemoveBlock(std::launder(reinterpret_cast<FreeBlock const*>(following_block_common)));
+				tail_size += following_block_common->info.GetSize();
+			}
+
+			if (tail_address + tail_size != GetBaseAddress() + CalcMemorySizeBytes())
+			{
+				CommonBlock* const following_block = std::launder(reinterpret_cast<CommonBlock*>(tail_address + tail_size));
+				following_block->prev_physical_block = tail_size;
+			}
+		}
+
+		InsertBlock({tail_address, tail_size}, needed_size_bytes);
 	}
+
+	return true;
 }
 
 void TLSFAllocator::InsertBlock(MemorySlice block, U64 prev_physical_block)
 {
 	// PAW_ASSERT(IsPointerAligned(block.ptr, sizeof(FreeBlock)), "Memory block pointer is not aligned");
 	PAW_ASSERT(block.size_bytes >= sizeof(FreeBlock), "Memory block size is not big enough for FreeBlock");
-	PAW_ASSERT(IsPointerAligned(block.ptr, 4), "Memory block pointer is not aligned");
+	PAW_ASSERT(IsPointerAligned(block.ptr, block_granularity), "Memory block pointer is not aligned");
 
 	PAW_ASSERT(block.size_bytes >= sizeof(FreeBlock), "Memory block is not big enough to contain tracking data (FreeBlock)");
 	Index const index = Map(block.size_bytes);
@@ -300,31 +459,38 @@ void TLSFAllocator::InsertBlock(MemorySlice block, U64 prev_physical_block)
 		head->prev_free_block = new_block;
 	}
 	head = new_block;
-	top_level_bitmap |= 1 << index.top_level;
-	second_level_bitmaps[index.top_level] |= 1 << index.second_level;
+	free_bin_block_counts[free_list_index]++;
+	free_block_count++;
+	free_bytes += block.size_bytes;
+	top_level_bitmap |= 1ull << index.top_level;
+	second_level_bitmaps[index.top_level] |= 1u << index.second_level;
 }
 
 void TLSFAllocator::RemoveBlock(FreeBlock const* const block)
 {
+	Index const index = Map(block->info.GetSize());
+	S32 const free_list_index = index.top_level * sub_bin_count + index.second_level;
+	free_bin_block_counts[free_list_index]--;
+	free_block_count--;
+	free_bytes -= block->info.GetSize();
+
 	if (block->prev_free_block != nullptr)
 	{
 		block->prev_free_block->next_free_block = block->next_free_block;
 	}
 	else
 	{
-		Index const index = Map(block->info.GetSize());
 		U32 const sub_bin_bitmap = second_level_bitmaps[index.top_level] & (~0u << index.second_level);
 		PAW_ASSERT(sub_bin_bitmap != 0, "This block exists and is free, so this should not be 0");
-		S32 const free_list_index = index.top_level * sub_bin_count + index.second_level;
 		FreeBlock*& head = second_level_pointers[free_list_index];
 		PAW_ASSERT(head == block, "next_block should be the head of the free list");
 		head = block->next_free_block;
 		if (head == nullptr)
 		{
-			second_level_bitmaps[index.top_level] &= ~(1 << index.second_level);
+			second_level_bitmaps[index.top_level] &= ~(1u << index.second_level);
 			if (second_level_bitmaps[index.top_level] == 0)
 			{
-				top_level_bitmap &= ~(1 << index.top_level);
+				top_level_bitmap &= ~(1ull << index.top_level);
 			}
 		}
 	}
@@ -335,28 +501,485 @@ void TLSFAllocator::RemoveBlock(FreeBlock const* const block)
 	}
 }
 
-void TLSFAllocator::Print()
+void TLSFAllocator::ReleaseFreePages(FreeBlock* block, Byte* dirty_begin, Byte* dirty_end)
 {
-	std::printf("========================================================================\n");
-	Byte* ptr = GetBaseAddress();
-	while (true)
+	Byte* const block_address = reinterpret_cast<Byte*>(block);
+	PtrSize const block_size = block->info.GetSize();
+	PtrSize const page_size = GetPageSize();
+
+	if (block == last_physical_block)
 	{
-		CommonBlock const* const block = std::launder(reinterpret_cast<CommonBlock*>(ptr));
-		bool const free = block->info.IsFree();
-		if (free)
+		if (release_policy.trailing_release_threshold_bytes == 0 || block_size < release_policy.trailing_release_threshold_bytes)
+		{
+			return;
+		}
+
+		// The header and trailing_keep_bytes stay, everything from the next page boundary on goes back to the OS
+		Byte* const heap_end = block_address + block_size;
+		Byte* const release_begin = AlignPointerForward(block_address + sizeof(FreeBlock) + release_policy.trailing_keep_bytes, page_size);
+		if (release_begin >= heap_end)
+		{
+			return;
+		}
+
+		U64 const prev_physical_block = block->prev_physical_block;
+		RemoveBlock(block);
+		FreePages(static_cast<PtrSize>(heap_end - release_begin) / page_size);
+		InsertBlock({block_address, static_cast<PtrSize>(release_begin - block_address)}, prev_physical_block);
+		return;
+	}
+
+	if (release_policy.interior_purge_threshold_bytes == 0 || block_size < release_policy.interior_purge_threshold_bytes)
+	{
+		return;
+	}
+
+	// Offsets from the page aligned base, only whole pages behind the header that overlap the dirty range get purged
+	Byte* const base_address = GetBaseAddress();
+	PtrSize const page_mask = page_size - 1;
+	PtrSize const block_offset = static_cast<PtrSize>(block_address - base_address);
+	PtrSize const interior_begin = AlignSizeForward(block_offset + sizeof(FreeBlock), page_size);
+	PtrSize const interior_end = (block_offset + block_size) & ~page_mask;
+	PtrSize const dirty_page_begin = static_cast<PtrSize>(dirty_begin - base_address) & ~page_mask;
+	PtrSize const dirty_page_end = AlignSizeForward(static_cast<PtrSize>(dirty_end - base_address), page_size);
+	PtrSize const purge_begin = interior_begin > dirty_page_begin ? interior_begin : dirty_page_begin;
+	PtrSize const purge_end = interior_end < dirty_page_end ? interior_end : dirty_page_end;
+	if (purge_begin < purge_end)
+	{
+		PurgePages(base_address + purge_begin, (purge_end - purge_begin) / page_size);
+	}
+	block->info.SetPurged();
+}
+
+TLSFStats TLSFAllocator::GetStats() const
+{
+	TLSFStats stats{
+		.free_bytes = free_bytes,
+		.used_bytes = GetPageCount() * GetPageSize() - free_bytes,
+		.free_block_count = free_block_count,
+		.used_block_count = used_block_count,
+	};
+
+	for (S32 top_level = 0; top_level < top_level_count; top_level++)
+	{
+		for (S32 second_level = 0; second_level < sub_bin_count; second_level++)
+		{
+			stats.top_level_free_block_counts[top_level] += static_cast<S32>(free_bin_block_counts[top_level * sub_bin_count + second_level]);
+		}
+	}
+
+	// The largest block is in the highest non-empty bin, only that one list has to be searched
+	if (top_level_bitmap != 0)
+	{
+		S32 const top_level = BitScanMSB(top_level_bitmap);
+		S32 const second_level = BitScanMSB(second_level_bitmaps[top_level]);
+		for (FreeBlock const* block = second_level_pointers[top_level * sub_bin_count + second_level]; block; block = block->next_free_block)
+		{
+			PtrSize const size_bytes = block->info.GetSize();
+			stats.largest_free_block_bytes = size_bytes > stats.largest_free_block_bytes ? size_bytes : stats.largest_free_block_bytes;
+		}
+		stats.external_fragmentation = 1.0f - static_cast<F32>(static_cast<F64>(stats.largest_free_block_bytes) / static_cast<F64>(free_bytes));
+	}
+
+	return stats;
+}
+
+Slice<U32 const> TLSFAllocator::GetFreeBinBlockCounts() const
+{
+	return {free_bin_block_counts, second_level_count};
+}
+
+bool TLSFAllocator::VerifyHeap() const
+{
+	Byte const* const heap_begin = GetBaseAddress();
+	Byte const* const heap_end = heap_begin + GetPageCount() * GetPageSize();
+
+	// Physical order: sizes add up to the heap, back links match and no two free blocks sit next to each other
+	PtrSize physical_free_bytes = 0;
+	S32 physical_free_block_count = 0;
+	S32 physical_used_block_count = 0;
+	U64 prev_block_size = 0;
+	bool prev_is_free = false;
+	CommonBlock const* block = nullptr;
+	for (Byte const* ptr = heap_begin; ptr < heap_end; ptr += block->info.GetSize())
+	{
+		block = std::launder(reinterpret_cast<CommonBlock const*>(ptr));
+		PtrSize const size_bytes = block->info.GetSize();
+		if (size_bytes < sizeof(FreeBlock) || size_bytes % block_granularity != 0 || size_bytes > static_cast<PtrSize>(heap_end - ptr))
+		{
+			return false;
+		}
+		if (block->prev_physical_block != prev_block_size)
+		{
+			return false;
+		}
+
+		bool const is_free = block->info.IsFree();
+		if (is_free && prev_is_free)
+		{
+			return false;
+		}
+
+		if (is_free)
 		{
-			FreeBlock const* const free_block = std::launder(reinterpret_cast<FreeBlock*>(ptr));
-			std::printf("Block: %s - %llu - next: %p, prev: %p\n", free ? "Free" : "Used", block->info.GetSize(), (void*)free_block->next_free_block, (void*)free_block->prev_free_block);
+			physical_free_bytes += size_bytes;
+			physical_free_block_count++;
 		}
 		else
 		{
-			std::printf("Block: %s - %llu\n", free ? "Free" : "Used", block->info.GetSize());
+			physical_used_block_count++;
 		}
-		if (block == last_physical_block)
+		prev_block_size = size_bytes;
+		prev_is_free = is_free;
+	}
+
+	if (block != last_physical_block)
+	{
+		return false;
+	}
+
+	// Free lists: every block is free, in the bin its size maps to, linked both ways and the bitmaps agree
+	PtrSize listed_free_bytes = 0;
+	S32 listed_free_block_count = 0;
+	for (S32 top_level = 0; top_level < top_level_count; top_level++)
+	{
+		if (((top_level_bitmap >> top_level) & 1) != (second_level_bitmaps[top_level] != 0))
 		{
-			break;
+			return false;
 		}
-		ptr += block->info.GetSize();
+
+		for (S32 second_level = 0; second_level < sub_bin_count; second_level++)
+		{
+			S32 const free_list_index = top_level * sub_bin_count + second_level;
+			FreeBlock const* const head = second_level_pointers[free_list_index];
+			if ((head != nullptr) != (((second_level_bitmaps[top_level] >> second_level) & 1) != 0))
+			{
+				return false;
+			}
+
+			U32 bin_block_count = 0;
+			FreeBlock const* prev_free_block = nullptr;
+			for (FreeBlock const* free_block = head; free_block; free_block = free_block->next_free_block)
+			{
+				Byte const* const free_block_address = reinterpret_cast<Byte const*>(free_block);
+				// Also stops a corrupted list from looping forever
+				if (free_block_address < heap_begin || free_block_address >= heap_end || listed_free_block_count >= physical_free_block_count)
+				{
+					return false;
+				}
+
+				Index const index = Map(free_block->info.GetSize());
+				if (!free_block->info.IsFree() || free_block->prev_free_block != prev_free_block || index.top_level != top_level || index.second_level != second_level)
+				{
+					return false;
+				}
+
+				listed_free_bytes += free_block->info.GetSize();
+				listed_free_block_count++;
+				bin_block_count++;
+				prev_free_block = free_block;
+			}
+
+			if (bin_block_count != free_bin_block_counts[free_list_index])
+			{
+				return false;
+			}
+		}
+	}
+
+	return listed_free_bytes == physical_free_bytes && listed_free_block_count == physical_free_block_count && free_bytes == physical_free_bytes && free_block_count == physical_free_block_count && used_block_count == physical_used_block_count;
+}
+
+// Threads claim a bit in this mask the first time they use a caching allocator and clear it again when they exit. The
+// next thread to claim the bit inherits whatever the previous one left in its magazines, unless TrimCaches emptied
+// them first.
+static std::atomic<U64> g_used_thread_cache_slots = 0;
+// TrimCaches calls running right now. They hold the unclaimed slots for a moment, threads wait for them instead of
+// giving up on getting a slot.
+static std::atomic<S32> g_thread_cache_trim_count = 0;
+
+struct ThreadCacheSlot
+{
+	// -1 hasn't tried to claim a slot yet, -2 found them all taken
+	S32 index = -1;
+
+	~ThreadCacheSlot()
+	{
+		if (index >= 0)
+		{
+			g_used_thread_cache_slots.fetch_and(~(1ull << index), std::memory_order_release);
+		}
+	}
+};
+
+static thread_local ThreadCacheSlot g_thread_cache_slot;
+
+static_assert(ThreadCachingTLSFAllocator::max_cached_thread_count == 64, "Thread cache slots are claimed from a 64 bit mask");
+
+static S32 ClaimThreadCacheSlot()
+{
+	if (g_thread_cache_slot.index == -1)
+	{
+		g_thread_cache_slot.index = -2;
+		U64 used_slots = g_used_thread_cache_slots.load(std::memory_order_relaxed);
+		while (true)
+		{
+			if (used_slots == ~0ull)
+			{
+				if (g_thread_cache_trim_count.load(std::memory_order_relaxed) == 0)
+				{
+					break;
+				}
+				std::this_thread::yield();
+				used_slots = g_used_thread_cache_slots.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			S32 const index = BitScanLSB(~used_slots);
+			if (g_used_thread_cache_slots.compare_exchange_weak(used_slots, used_slots | (1ull << index), std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				g_thread_cache_slot.index = index;
+				break;
+			}
+		}
+	}
+
+	return g_thread_cache_slot.index;
+}
+
+static S32 CalcSizeClass(PtrSize size_bytes)
+{
+	return static_cast<S32>((size_bytes - 1) / block_granularity);
+}
+
+ThreadCachingTLSFAllocator::ThreadCachingTLSFAllocator(PageConfig page_config)
+	: TLSFAllocator(page_config)
+{
+}
+
+ThreadCachingTLSFAllocator::~ThreadCachingTLSFAllocator()
+{
+}
+
+MemorySlice ThreadCachingTLSFAllocator::Alloc(PtrSize size_bytes, PtrSize alignment)
+{
+	// Sizes of 0 wrap around and skip the cache
+	bool const is_cacheable = size_bytes - 1 < max_cached_size_bytes && alignment <= block_granularity;
+	ThreadCache* const cache = is_cacheable ? GetThreadCache() : nullptr;
+	if (!cache)
+	{
+		std::lock_guard const lock(heap_mutex);
+		FreeDeferred();
+		return TLSFAllocator::Alloc(size_bytes, alignment);
+	}
+
+	S32 const size_class = CalcSizeClass(size_bytes);
+	Magazine& magazine = cache->magazines[size_class];
+	S32 count = magazine.count.load(std::memory_order_relaxed);
+	if (count == 0)
+	{
+		std::lock_guard const lock(heap_mutex);
+		FreeDeferred();
+
+		PtrSize const class_size_bytes = static_cast<PtrSize>(size_class + 1) * block_granularity;
+		while (count < batch_count)
+		{
+			MemorySlice const block = TLSFAllocator::Alloc(class_size_bytes, block_granularity);
+			if (!block.ptr)
+			{
+				break;
+			}
+			magazine.blocks[count++] = block.ptr;
+		}
+
+		if (count == 0)
+		{
+			return {};
+		}
+	}
+
+	count--;
+	magazine.count.store(count, std::memory_order_relaxed);
+	return {magazine.blocks[count], size_bytes};
+}
+
+void ThreadCachingTLSFAllocator::Free(MemorySlice memory)
+{
+	// Only blocks without alignment padding are sure to have room for their whole size class, see GetUsedBlockAddress
+	bool const is_cacheable = memory.size_bytes - 1 < max_cached_size_bytes && memory.ptr[-1] == 0;
+	ThreadCache* const cache = is_cacheable ? GetThreadCache() : nullptr;
+	if (cache)
+	{
+		Magazine& magazine = cache->magazines[CalcSizeClass(memory.size_bytes)];
+		if (magazine.count.load(std::memory_order_relaxed) == magazine_capacity)
+		{
+			FlushBatch(magazine);
+		}
+		S32 const count = magazine.count.load(std::memory_order_relaxed);
+		magazine.blocks[count] = memory.ptr;
+		magazine.count.store(count + 1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (heap_mutex.try_lock())
+	{
+		FreeDeferred();
+		TLSFAllocator::Free(memory);
+		heap_mutex.unlock();
+		return;
+	}
+
+	DeferredFree* const node = new (memory.ptr) DeferredFree{deferred_free_head.load(std::memory_order_relaxed)};
+	while (!deferred_free_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+}
+
+bool ThreadCachingTLSFAllocator::TryResize(MemorySlice memory, PtrSize new_size_bytes)
+{
+	std::lock_guard const lock(heap_mutex);
+	FreeDeferred();
+	return TLSFAllocator::TryResize(memory, new_size_bytes);
+}
+
+void ThreadCachingTLSFAllocator::TrimCaches()
+{
+	// Hold every slot no thread has claimed so nobody picks one up while its cache is being emptied
+	g_thread_cache_trim_count.fetch_add(1, std::memory_order_relaxed);
+	U64 const trimmed_slots = ~g_used_thread_cache_slots.fetch_or(~0ull, std::memory_order_acquire);
+
+	S32 const own_slot_index = g_thread_cache_slot.index;
+	{
+		std::lock_guard const lock(heap_mutex);
+		FreeDeferred();
+
+		for (S32 slot_index = 0; slot_index < max_cached_thread_count; slot_index++)
+		{
+			bool const is_abandoned = (trimmed_slots & (1ull << slot_index)) != 0;
+			ThreadCache* const cache = thread_caches[slot_index].load(std::memory_order_relaxed);
+			if (!cache || (!is_abandoned && slot_index != own_slot_index))
+			{
+				continue;
+			}
+
+			for (Magazine& magazine : cache->magazines)
+			{
+				S32 const count = magazine.count.load(std::memory_order_relaxed);
+				for (S32 i = 0; i < count; i++)
+				{
+					TLSFAllocator::Free({magazine.blocks[i], 0});
+				}
+				magazine.count.store(0, std::memory_order_relaxed);
+			}
+
+			// The calling thread keeps its cache, abandoned ones get made again when their slot is claimed
+			if (is_abandoned)
+			{
+				TLSFAllocator::Free({reinterpret_cast<Byte*>(cache), 0});
+				thread_caches[slot_index].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	g_used_thread_cache_slots.fetch_and(~trimmed_slots, std::memory_order_release);
+	g_thread_cache_trim_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+TLSFStats ThreadCachingTLSFAllocator::GetStats() const
+{
+	std::lock_guard const lock(heap_mutex);
+	TLSFStats stats = TLSFAllocator::GetStats();
+
+	// Caches are only made and freed under the lock. Running threads keep changing their counts, so the sum is a snapshot.
+	for (std::atomic<ThreadCache*> const& slot : thread_caches)
+	{
+		ThreadCache const* const cache = slot.load(std::memory_order_relaxed);
+		if (!cache)
+		{
+			continue;
+		}
+
+		for (S32 size_class = 0; size_class < size_class_count; size_class++)
+		{
+			PtrSize const class_size_bytes = static_cast<PtrSize>(size_class + 1) * block_granularity;
+			stats.cached_bytes += static_cast<PtrSize>(cache->magazines[size_class].count.load(std::memory_order_relaxed)) * class_size_bytes;
+		}
+	}
+
+	return stats;
+}
+
+bool ThreadCachingTLSFAllocator::VerifyHeap() const
+{
+	std::lock_guard const lock(heap_mutex);
+	return TLSFAllocator::VerifyHeap();
+}
+
+ThreadCachingTLSFAllocator::ThreadCache* ThreadCachingTLSFAllocator::GetThreadCache()
+{
+	S32 const slot_index = ClaimThreadCacheSlot();
+	if (slot_index < 0)
+	{
+		return nullptr;
+	}
+
+	// Only the thread holding the slot touches its cache, the slot mask orders it with the thread that held it before
+	ThreadCache* cache = thread_caches[slot_index].load(std::memory_order_relaxed);
+	if (!cache)
+	{
+		std::lock_guard const lock(heap_mutex);
+		MemorySlice const memory = TLSFAllocator::Alloc(sizeof(ThreadCache), alignof(ThreadCache));
+		if (!memory.ptr)
+		{
+			return nullptr;
+		}
+		cache = new (memory.ptr) ThreadCache{};
+		thread_caches[slot_index].store(cache, std::memory_order_relaxed);
+	}
+
+	return cache;
+}
+
+void ThreadCachingTLSFAllocator::FlushBatch(Magazine& magazine)
+{
+	// The oldest blocks go back, the most recently freed ones are the likeliest to still be in cache
+	if (heap_mutex.try_lock())
+	{
+		FreeDeferred();
+		for (S32 i = 0; i < batch_count; i++)
+		{
+			TLSFAllocator::Free({magazine.blocks[i], 0});
+		}
+		heap_mutex.unlock();
+	}
+	else
+	{
+		DeferredFree* const first = new (magazine.blocks[0]) DeferredFree{nullptr};
+		DeferredFree* last = first;
+		for (S32 i = 1; i < batch_count; i++)
+		{
+			last->next = new (magazine.blocks[i]) DeferredFree{nullptr};
+			last = last->next;
+		}
+
+		last->next = deferred_free_head.load(std::memory_order_relaxed);
+		while (!deferred_free_head.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	S32 const count = magazine.count.load(std::memory_order_relaxed);
+	std::memmove(magazine.blocks, magazine.blocks + batch_count, sizeof(magazine.blocks[0]) * (count - batch_count));
+	magazine.count.store(count - batch_count, std::memory_order_relaxed);
+}
+
+void ThreadCachingTLSFAllocator::FreeDeferred()
+{
+	DeferredFree* node = deferred_free_head.exchange(nullptr, std::memory_order_acquire);
+	while (node)
+	{
+		DeferredFree* const next = node->next;
+		TLSFAllocator::Free({reinterpret_cast<Byte*>(node), 0});
+		node = next;
 	}
-	std::printf("========================================================================\n");
 }
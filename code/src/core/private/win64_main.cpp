@@ -298,7 +298,7 @@ struct JobLink
 class Job
 {
 public:
-	Job(StringView8 name, SrcLocation src_loc, JobBase& callable, S32 dependency_count, JobGraph& graph)
+	Job(StringId name, SrcLocation src_loc, JobBase& callable, S32 dependency_count, JobGraph& graph)
 		: name(name)
 		, src_location(src_loc)
 		, callable(callable)
@@ -325,13 +325,13 @@ public:
 
 	void Execute();
 
-	StringView8 GetName() const
+	StringId GetName() const
 	{
 		return name;
 	}
 
 private:
-	StringView8 const name;
+	StringId const name;
 	SrcLocation const src_location;
 	JobBase& callable;
 	JobGraph& graph;
@@ -353,17 +353,11 @@ class JobGraph : NonCopyable
 public:
 	JobGraph(JobQueue& job_queue, IAllocator* persistant_allocator)
 		: job_queue(job_queue)
-		, allocators(PAW_NEW_SLICE_IN(persistant_allocator, job_queue.GetWorkerCount(), ArenaAllocator))
 	{
 		PAW_UNUSED_ARG(persistant_allocator);
 	}
 
-	~JobGraph()
-	{
-		PAW_DELETE_SLICE(allocators);
-	}
-
-	Job& PushJob(SrcLocation src_loc, StringView8 name, JobBase& callbable, Slice<JobHandle const> const& dependencies, Slice<JobResource const> const& resources)
+	Job& PushJob(SrcLocation src_loc, StringId name, JobBase& callbable, Slice<JobHandle const> const& dependencies, Slice<JobResource const> const& resources)
 	{
 		PAW_UNUSED_ARG(resources);
 		IAllocator* allocator = GetAllocator();
@@ -393,7 +387,7 @@ public:
 
 	IAllocator* GetAllocator()
 	{
-		return &allocators[g_worker_index];
+		return &allocator;
 	}
 
 	JobGraphState GetState() const
@@ -410,8 +404,8 @@ private:
 
 	JobQueue& job_queue;
 	// This allocator lifetime matches the lifetime of a single graph execution. Jobs can use it for temporary memory
-	// And it can also be used for bookkeeping that matches that lifetime
-	Slice<ArenaAllocator> const allocators;
+	// And it can also be used for bookkeeping that matches that lifetime. Every worker appends to the same arena
+	ConcurrentArenaAllocator allocator;
 	std::atomic<JobGraphState> state = JobGraphState::Active;
 };
 
@@ -495,7 +489,7 @@ public:
 static inline constexpr JobHandle g_null_job = JobHandle{(PtrSize)-1};
 
 template <typename... Args, typename... Inputs>
-Job& JobGraphAddJob(JobGraph& graph, SrcLocation&& src, StringView8 const& name, Slice<JobHandle const> const& dependencies, JobGraphFuncPointer<Args...> func, Inputs&&... inputs)
+Job& JobGraphAddJob(JobGraph& graph, SrcLocation&& src, StringId name, Slice<JobHandle const> const& dependencies, JobGraphFuncPointer<Args...> func, Inputs&&... inputs)
 {
 	// constexpr PtrSize resource_count = (... + [&]
 	//								  {
@@ -580,7 +574,7 @@ static void TestSubJob(JobGraph& /*graph*/, JobHandle /*job*/, StringView8 name)
 static void TestJob(JobGraph& graph, JobHandle job, StringView8 name)
 {
 	PAW_INFO("TestJob: " PAW_STR_FMT "\n", PAW_FMT_STR(name));
-	JobGraphAddJob(graph, SrcLoc(), PAW_STR("Test Sub Job"), {job}, TestSubJob, name);
+	JobGraphAddJob(graph, SrcLoc(), PAW_SID("Test Sub Job"), {job}, TestSubJob, name);
 }
 
 #if 0
@@ -771,11 +765,11 @@ int PlatformMain(int arg_count, char* args[])
 	JobQueue job_queue{&persistent_allocator};
 	JobGraph job_graph{job_queue, &persistent_allocator};
 
-	Job& parent_job = JobGraphAddJob(job_graph, SrcLoc(), PAW_STR("Parent"), {}, TestJob, PAW_STR("Parent"));
+	Job& parent_job = JobGraphAddJob(job_graph, SrcLoc(), PAW_SID("Parent"), {}, TestJob, PAW_STR("Parent"));
 	Slice<JobHandle const> const deps{JobHandle{(PtrSize)&parent_job}};
-	Job& child_job0 = JobGraphAddJob(job_graph, SrcLoc(), PAW_STR("Child 0"), deps, TestJob, PAW_STR("Child 0"));
-	Job& child_job1 = JobGraphAddJob(job_graph, SrcLoc(), PAW_STR("Child 1"), deps, TestJob, PAW_STR("Child 1"));
-	JobGraphAddJob(job_graph, SrcLoc(), PAW_STR("Child 1"), {JobHandle{(PtrSize)&child_job0}, JobHandle{(PtrSize)&child_job1}}, TestJob, PAW_STR("Grandchild"));
+	Job& child_job0 = JobGraphAddJob(job_graph, SrcLoc(), PAW_SID("Child 0"), deps, TestJob, PAW_STR("Child 0"));
+	Job& child_job1 = JobGraphAddJob(job_graph, SrcLoc(), PAW_SID("Child 1"), deps, TestJob, PAW_STR("Child 1"));
+	JobGraphAddJob(job_graph, SrcLoc(), PAW_SID("Child 1"), {JobHandle{(PtrSize)&child_job0}, JobHandle{(PtrSize)&child_job1}}, TestJob, PAW_STR("Grandchild"));
 	job_graph.Schedule(parent_job);
 #endif
 	// IDXGIOutput* output = nullptr;
@@ -801,20 +795,3 @@ extern "C"
 {
 	__declspec(dllexport) extern char const* D3D12SDKPath = ".\\";
 }
-
-Byte* PlatformReserveAddressSpace(PtrSize size_bytes)
-{
-	void* const address_space = VirtualAlloc2(nullptr, nullptr, size_bytes, MEM_RESERVE, PAGE_NOACCESS, nullptr, 0);
-	Byte* const result = reinterpret_cast<Byte*>(address_space);
-	return result;
-}
-
-void PlatformCommitAddressSpace(Byte* start_ptr, PtrSize size_bytes)
-{
-	VirtualAlloc(start_ptr, size_bytes, MEM_COMMIT, PAGE_READWRITE);
-}
-
-void PlatformDecommitAddressSpace(Byte* start_ptr, PtrSize size_bytes)
-{
-	VirtualFree(start_ptr, size_bytes, MEM_DECOMMIT);
-}
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <core/arena_types.h>
+#include <core/memory.h>
 #include <core/memory_types.h>
 #include <core/slice_types.h>
 #include <core/assert.h>
 
+#include <atomic>
+
 struct ArenaMarker_t
 {
 	PtrSize head;
+	// Only set by arenas whose blocks aren't always created at the head. Blocks from here on are newer than the marker.
+	PtrSize committed_end = 0;
 };
 
 class FixedSizeArenaAllocator final : public IAllocator
@@ -19,11 +24,15 @@ public:
 	void InitFromMemory(Byte* memory, PtrSize size_bytes);
 
 	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	// Only the most recent allocation is reclaimed
 	void Free(MemorySlice memory) override;
+	// Only the most recent allocation can grow, any allocation can shrink (the tail is only reclaimed for the most recent one)
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
 
 	void FreeAll();
 
-	void FreeToMarker(ArenaMarker_t marker);
+	// The memory isn't owned by the arena so there are never pages to release
+	void FreeToMarker(ArenaMarker_t marker, bool release_pages = false);
 	ArenaMarker_t GetMarker() const;
 	PtrSize GetFreeBytes() const;
 	PtrSize GetTotalSizeBytes() const;
@@ -59,53 +68,125 @@ private:
 };
 #endif
 
+// Grows in blocks that double in size up to max_block_size_bytes, each block starts with a small header linking it to
+// the previous one so there's no limit on the block count. Allocations too big for a quarter of the next block get a
+// dedicated span of their own and the current block keeps bumping.
 class PagedArenaAllocator final : public IAllocator
 {
 public:
-	PagedArenaAllocator();
+	PagedArenaAllocator(PageConfig page_config = {});
 	~PagedArenaAllocator();
 
 	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	// Only the most recent allocation is reclaimed, a dedicated span goes back entirely when it's the newest block
 	void Free(MemorySlice memory) override;
+	// The most recent allocation can grow up to the end of its block
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
 
 	void FreeAll();
 
-	void FreeToMarker(ArenaMarker_t marker);
+	// Blocks newer than the marker are always handed back, release_pages has no effect
+	void FreeToMarker(ArenaMarker_t marker, bool release_pages = false);
 	ArenaMarker_t GetMarker() const;
 	S32 GetPageCount() const;
+	S32 GetBlockCount() const;
 	PtrSize GetFreeBytesInPage() const;
 
+	static constexpr PtrSize max_block_size_bytes = MegaBytes(16);
+
 private:
-	struct Page
+	struct Block
 	{
-		MemorySlice memory;
-		PtrSize used = 0;
+		Block* prev_block;
+		PtrSize used;
+		PtrSize size_bytes;
+		bool is_dedicated;
 	};
 
-	Page const& GetCurrentPage() const;
-	Page& GetCurrentPage();
+	Block* AddBlock(PtrSize size_bytes, bool is_dedicated);
+	void PopLastBlock();
+	static MemorySlice AllocFromBlock(Block& block, PtrSize size_Bytes, PtrSize alignment);
 
-	static constexpr S32 max_page_count = 32;
-
-	Page pages[max_page_count]{};
+	// Newest block by address, which is also the newest by creation
+	Block* last_block = nullptr;
+	// Block the small allocations bump out of, dedicated spans never become the current block
+	Block* current_block = nullptr;
+	PtrSize next_block_size_Bytes = 0;
 };
 
 class ArenaAllocator final : public IAllocator
 {
 public:
-	ArenaAllocator();
+	ArenaAllocator(PageConfig page_config = {});
 	~ArenaAllocator();
 
 	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	// Only the most recent allocation is reclaimed
 	void Free(MemorySlice memory) override;
+	// The most recent allocation grows by committing more pages, the reservation behind it is contiguous
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
 
 	void FreeAll();
 
-	void FreeToMarker(ArenaMarker_t marker);
+	// Pages past the marker stay in use for the next allocations unless release_pages is set, in which case they go
+	// back through FreePages and get decommitted according to the retention policy
+	void FreeToMarker(ArenaMarker_t marker, bool release_pages = false);
 	ArenaMarker_t GetMarker() const;
 
 	S32 GetPageCount() const;
 
 private:
 	PtrSize used_Bytes = 0;
-};
\ No newline at end of file
+};
+
+// Bump arena any number of threads can allocate from at once. Allocations are a fetch-add on the head, only running
+// past the committed memory takes the slow path where one thread commits more pages while the others wait for it.
+class ConcurrentArenaAllocator final : public IAllocator
+{
+public:
+	ConcurrentArenaAllocator(PageConfig page_config = {});
+	~ConcurrentArenaAllocator();
+
+	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	// Individual allocations are never reclaimed, only FreeAll gives memory back
+	void Free(MemorySlice memory) override;
+
+	// Not thread safe, nothing can be allocating while the arena is reset
+	void FreeAll();
+
+	PtrSize GetUsedBytes() const;
+
+private:
+	// The head moves in multiples of this, allocations aligned to it or less don't waste any padding
+	static constexpr PtrSize base_alignment = 16;
+
+	bool CommitUpTo(PtrSize end_Bytes);
+
+	std::atomic<PtrSize> head_Bytes = 0;
+	std::atomic<PtrSize> committed_Bytes = 0;
+	std::atomic<bool> committing = false;
+};
+
+// Rewinds the arena back to where it was when the scope was opened. Scopes on the same arena have to close in the
+// reverse order they were opened in.
+template <typename ArenaType>
+class ArenaTempScope : NonCopyable
+{
+public:
+	explicit ArenaTempScope(ArenaType& arena, bool release_pages = false)
+		: arena(arena)
+		, marker(arena.GetMarker())
+		, release_pages(release_pages)
+	{
+	}
+
+	~ArenaTempScope()
+	{
+		arena.FreeToMarker(marker, release_pages);
+	}
+
+private:
+	ArenaType& arena;
+	ArenaMarker_t const marker;
+	bool const release_pages;
+};
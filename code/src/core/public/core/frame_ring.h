@@ -0,0 +1,63 @@
+#pragma once
+
+#include <core/memory.h>
+#include <core/memory_types.h>
+
+struct FrameRingStats
+{
+	PtrSize current_frame_bytes = 0;
+	PtrSize last_frame_bytes = 0;
+	// Largest single frame so far, times the number of frames in flight is roughly what the ring settles at
+	PtrSize peak_frame_bytes = 0;
+	PtrSize committed_bytes = 0;
+	S32 chunk_count = 0;
+};
+
+// Per-frame allocator for data that has to outlive the frame it was written in until that frame retires, e.g. while
+// the GPU is still reading it. Memory is handed out from a ring of chunks, a chunk is reused once every frame that
+// allocated from it has retired and a new chunk is committed when the next one in the ring is still in flight.
+// Frames are any increasing value, such as the fence value the frame signals.
+class FrameRingAllocator final : public IAllocator
+{
+public:
+	FrameRingAllocator(PtrSize chunk_size_bytes = MegaBytes(1), PageConfig page_config = {});
+	~FrameRingAllocator();
+
+	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	// Memory is only reclaimed when its frame retires
+	void Free(MemorySlice memory) override;
+
+	// Everything allocated until the next BeginFrame belongs to this frame
+	void BeginFrame(U64 frame);
+	// Every frame up to and including completed_frame is done with its memory
+	void RetireFrames(U64 completed_frame);
+
+	FrameRingStats GetStats() const;
+
+private:
+	struct Chunk
+	{
+		Byte* ptr = nullptr;
+		PtrSize size_bytes = 0;
+		PtrSize used = 0;
+		U64 last_frame = 0;
+		S32 next_chunk_index = -1;
+	};
+
+	bool IsRetired(Chunk const& chunk) const;
+	S32 AddChunk(PtrSize min_size_bytes);
+
+	static constexpr S32 max_chunk_count = 64;
+
+	Chunk chunks[max_chunk_count]{};
+	S32 chunk_count = 0;
+	S32 current_chunk_index = -1;
+	PtrSize const chunk_size_Bytes;
+
+	U64 current_frame = 0;
+	U64 first_live_frame = 0;
+
+	PtrSize current_frame_Bytes = 0;
+	PtrSize last_frame_Bytes = 0;
+	PtrSize peak_frame_Bytes = 0;
+};
@@ -2,6 +2,7 @@
 
 #include <core/std.h>
 #include <core/memory_types.h>
+#include <core/string_id.h>
 #include <core/string_types.h>
 #include <core/gfx_types.h>
 
@@ -292,7 +293,7 @@ namespace Gfx
 		S32 width;
 		S32 height;
 		Format format;
-		StringView8 name = PAW_STR("Unknown Texture");
+		StringId name = PAW_SID("Unknown Texture");
 		InitialState initial_state = InitialState::Undefined;
 		ClearValue clear_value;
 		S32 sample_count = 1;
@@ -309,7 +310,7 @@ namespace Gfx
 
 	void BuildGraph(Gfx::State& state, GraphBuilder& builder);
 
-	GraphPass& GraphCreatePass(GraphBuilder& builder, StringView8 name);
+	GraphPass& GraphCreatePass(GraphBuilder& builder, StringId name);
 	GraphTexture GraphCreateTexture(GraphBuilder& builder, GraphPass& pass, GraphTextureDesc&& desc);
 	GraphTexture GraphReadTexture(GraphBuilder& builder, GraphPass& pass, GraphTexture texture, Gfx::Access access);
 	GraphTexture GraphWriteTexture(GraphBuilder& builder, GraphPass& pass, GraphTexture texture, Gfx::Access access);
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <core/assert.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/slice_types.h>
+
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+struct Handle
+{
+	S32 index;
+	U32 generation;
+};
+
+template <typename T>
+inline bool operator==(Handle<T> a, Handle<T> b)
+{
+	return a.index == b.index && a.generation == b.generation;
+}
+
+// Objects addressed by handles instead of pointers. Live items are packed at the front of one array so walking all of
+// them is a linear scan, freeing an item moves the last one into its place. Handle indices go through a separate
+// index -> item position array, and a generation per index is bumped on every free so stale handles are caught.
+// The arrays double when they're full, handles stay valid but pointers into the pool only last until the next Alloc or
+// Free.
+template <typename T>
+class HandlePool : NonCopyable
+{
+public:
+	static constexpr S32 null_index = -1;
+	// Generation 0 is never handed out, so a zeroed handle is never valid
+	static constexpr Handle<T> null_handle{null_index, 0};
+
+	HandlePool() = default;
+
+	explicit HandlePool(IAllocator* allocator, S32 initial_capacity = 0)
+	{
+		Init(allocator, initial_capacity);
+	}
+
+	~HandlePool()
+	{
+		Clear();
+		FreeArrays();
+	}
+
+	void Init(IAllocator* allocator, S32 initial_capacity = 0)
+	{
+		this->allocator = allocator;
+		if (initial_capacity > capacity)
+		{
+			Grow(initial_capacity);
+		}
+	}
+
+	template <typename... ArgTypes>
+	Handle<T> Alloc(ArgTypes&&... args)
+	{
+		if (count == capacity)
+		{
+			Grow(capacity > 0 ? capacity * 2 : 16);
+		}
+
+		S32 index = first_free_index;
+		if (index != null_index)
+		{
+			first_free_index = item_positions[index];
+		}
+		else
+		{
+			index = index_count++;
+			generations[index] = 1;
+		}
+
+		new (items + count, PlacementNewTag_t{}) T(std::forward<ArgTypes>(args)...);
+		item_indices[count] = index;
+		item_positions[index] = count;
+		count++;
+		return {index, generations[index]};
+	}
+
+	void Free(Handle<T> handle)
+	{
+		CheckHandle(handle);
+		S32 const position = item_positions[handle.index];
+		S32 const last_position = count - 1;
+		if (position != last_position)
+		{
+			items[position] = std::move(items[last_position]);
+			item_indices[position] = item_indices[last_position];
+			item_positions[item_indices[position]] = position;
+		}
+		items[last_position].~T();
+		count--;
+
+		U32 const next_generation = generations[handle.index] + 1;
+		generations[handle.index] = next_generation != 0 ? next_generation : 1;
+		item_positions[handle.index] = first_free_index;
+		first_free_index = handle.index;
+	}
+
+	// Destroys every item, all handles handed out so far become invalid
+	void Clear()
+	{
+		while (count > 0)
+		{
+			Free(GetHandle(count - 1));
+		}
+	}
+
+	bool IsValid(Handle<T> handle) const
+	{
+		if (handle.index < 0 || handle.index >= index_count || generations[handle.index] != handle.generation)
+		{
+			return false;
+		}
+
+		// Free indices reuse item_positions for the free list, so also check the position really points back here
+		S32 const position = item_positions[handle.index];
+		return position >= 0 && position < count && item_indices[position] == handle.index;
+	}
+
+	void CheckHandle(Handle<T> handle) const
+	{
+		PAW_ASSERT(handle.index != null_index, "Index is null");
+		PAW_ASSERT(handle.index >= 0 && handle.index < index_count, "Invalid index");
+		PAW_ASSERT(IsValid(handle), "Generations do not match");
+	}
+
+	T& GetValue(Handle<T> handle)
+	{
+		CheckHandle(handle);
+		return items[item_positions[handle.index]];
+	}
+
+	T const& GetValue(Handle<T> handle) const
+	{
+		CheckHandle(handle);
+		return items[item_positions[handle.index]];
+	}
+
+	S32 GetCount() const
+	{
+		return count;
+	}
+
+	// The live items, packed. Their order changes whenever something is freed.
+	Slice<T> GetItems()
+	{
+		return {items, count};
+	}
+
+	Slice<T const> GetItems() const
+	{
+		return {items, count};
+	}
+
+	// Handle of the item at a position in GetItems
+	Handle<T> GetHandle(S32 position) const
+	{
+		PAW_ASSERT(position >= 0 && position < count, "Position is not in range");
+		S32 const index = item_indices[position];
+		return {index, generations[index]};
+	}
+
+	T* begin()
+	{
+		return items;
+	}
+
+	T* end()
+	{
+		return items + count;
+	}
+
+private:
+	void Grow(S32 new_capacity)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			items = ResizeArray(items, new_capacity);
+		}
+		else
+		{
+			T* const new_items = reinterpret_cast<T*>(AllocMem(sizeof(T) * new_capacity, alignof(T), allocator, SrcLoc()).ptr);
+			PAW_ASSERT(new_items != nullptr, "Failed to grow the pool");
+			for (S32 i = 0; i < count; i++)
+			{
+				new (new_items + i, PlacementNewTag_t{}) T(std::move(items[i]));
+				items[i].~T();
+			}
+			if (items)
+			{
+				PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(items), sizeof(T) * capacity}));
+			}
+			items = new_items;
+		}
+		item_indices = ResizeArray(item_indices, new_capacity);
+		item_positions = ResizeArray(item_positions, new_capacity);
+		generations = ResizeArray(generations, new_capacity);
+		capacity = new_capacity;
+	}
+
+	template <typename ItemType>
+	ItemType* ResizeArray(ItemType* array, S32 new_capacity)
+	{
+		MemorySlice const memory = array ? PAW_RESIZE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(array), sizeof(ItemType) * capacity}), sizeof(ItemType) * new_capacity, alignof(ItemType))
+										 : AllocMem(sizeof(ItemType) * new_capacity, alignof(ItemType), allocator, SrcLoc());
+		PAW_ASSERT(memory.ptr != nullptr, "Failed to grow the pool");
+		return reinterpret_cast<ItemType*>(memory.ptr);
+	}
+
+	void FreeArrays()
+	{
+		if (capacity == 0)
+		{
+			return;
+		}
+
+		PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(items), sizeof(T) * capacity}));
+		PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(item_indices), sizeof(S32) * capacity}));
+		PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(item_positions), sizeof(S32) * capacity}));
+		PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(generations), sizeof(U32) * capacity}));
+	}
+
+	IAllocator* allocator = nullptr;
+	// Packed live items and the handle index of each
+	T* items = nullptr;
+	S32* item_indices = nullptr;
+	// Per handle index: the item's position while it's live, the next free index while it's free
+	S32* item_positions = nullptr;
+	U32* generations = nullptr;
+	S32 count = 0;
+	// Indices handed out at least once, with no free index they are all live so this equals count
+	S32 index_count = 0;
+	S32 capacity = 0;
+	S32 first_free_index = null_index;
+};
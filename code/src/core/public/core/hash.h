@@ -0,0 +1,272 @@
+#pragma once
+
+#include <core/std.h>
+#include <core/string_types.h>
+
+#include <cstring>
+#include <type_traits>
+
+// Fast non-cryptographic 64-bit hashing. Inputs up to 16 bytes are one 128-bit multiply, up to 256 bytes are a sum of
+// independent multiplies over 16 byte chunks and anything longer runs eight 64-bit accumulators over 64 byte stripes,
+// which is the part that goes through SSE2. Everything is constexpr, so HashLiteral gives the exact value Hash64 returns
+// for the same bytes at runtime. Not stable across versions of this file, don't write the results to disk.
+
+inline constexpr PtrSize hash_stripe_size_bytes = 64;
+inline constexpr U32 hash_stripes_per_block = 16;
+inline constexpr PtrSize hash_bulk_threshold_bytes = 256;
+
+struct HashSecret
+{
+	U64 values[40];
+};
+
+// Keys mixed into the input, stripe s of a block uses values[s..s+8), the scramble at the end of a block uses
+// values[24..32) and the accumulators start from values[32..40)
+constexpr HashSecret CalcHashSecret()
+{
+	HashSecret secret{};
+	U64 x = 0x9E3779B97F4A7C15ull;
+	for (U64& value : secret.values)
+	{
+		x += 0x9E3779B97F4A7C15ull;
+		U64 z = x;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		value = z ^ (z >> 31);
+	}
+	return secret;
+}
+
+inline constexpr HashSecret g_hash_secret = CalcHashSecret();
+
+// Folds the 128-bit product back into 64 bits
+constexpr U64 HashMum(U64 a, U64 b)
+{
+	unsigned __int128 const product = static_cast<unsigned __int128>(a) * b;
+	return static_cast<U64>(product) ^ static_cast<U64>(product >> 64);
+}
+
+constexpr U64 HashAvalanche(U64 h)
+{
+	h ^= h >> 37;
+	h *= 0x165667919E3779F9ull;
+	h ^= h >> 32;
+	return h;
+}
+
+template <typename CharType>
+constexpr U64 HashRead64(CharType const* ptr)
+{
+	if (std::is_constant_evaluated())
+	{
+		U64 value = 0;
+		for (S32 i = 0; i < 8; i++)
+		{
+			value |= static_cast<U64>(static_cast<U8>(ptr[i])) << (i * 8);
+		}
+		return value;
+	}
+
+	U64 value;
+	std::memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+template <typename CharType>
+constexpr U64 HashRead32(CharType const* ptr)
+{
+	if (std::is_constant_evaluated())
+	{
+		U64 value = 0;
+		for (S32 i = 0; i < 4; i++)
+		{
+			value |= static_cast<U64>(static_cast<U8>(ptr[i])) << (i * 8);
+		}
+		return value;
+	}
+
+	U32 value;
+	std::memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+// The SSE2 version of HashAccumulateScalar, gives the same result
+void HashAccumulateSimd(U64* acc, Byte const* data, PtrSize stripe_count, U32& block_stripe);
+
+constexpr void HashAccumulateStripe(U64* acc, U64 const* stripe, U32 secret_offset)
+{
+	for (U32 i = 0; i < 8; i++)
+	{
+		U64 const key = stripe[i] ^ g_hash_secret.values[secret_offset + i];
+		acc[i ^ 1] += stripe[i];
+		acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+	}
+}
+
+constexpr void HashScramble(U64* acc)
+{
+	for (U32 i = 0; i < 8; i++)
+	{
+		U64 value = acc[i];
+		value ^= value >> 47;
+		value ^= g_hash_secret.values[24 + i];
+		acc[i] = value * 0x9E3779B1ull;
+	}
+}
+
+template <typename CharType>
+constexpr void HashAccumulateScalar(U64* acc, CharType const* data, PtrSize stripe_count, U32& block_stripe)
+{
+	for (PtrSize stripe_index = 0; stripe_index < stripe_count; stripe_index++)
+	{
+		U64 stripe[8]{};
+		for (S32 i = 0; i < 8; i++)
+		{
+			stripe[i] = HashRead64(data + stripe_index * hash_stripe_size_bytes + i * 8);
+		}
+		HashAccumulateStripe(acc, stripe, block_stripe);
+
+		if (++block_stripe == hash_stripes_per_block)
+		{
+			HashScramble(acc);
+			block_stripe = 0;
+		}
+	}
+}
+
+template <typename CharType>
+constexpr void HashAccumulate(U64* acc, CharType const* data, PtrSize stripe_count, U32& block_stripe)
+{
+	if constexpr (sizeof(CharType) == 1)
+	{
+		if (!std::is_constant_evaluated())
+		{
+			HashAccumulateSimd(acc, reinterpret_cast<Byte const*>(data), stripe_count, block_stripe);
+			return;
+		}
+	}
+	HashAccumulateScalar(acc, data, stripe_count, block_stripe);
+}
+
+constexpr void HashInitAccumulators(U64* acc, U64 seed)
+{
+	for (S32 i = 0; i < 8; i++)
+	{
+		acc[i] = g_hash_secret.values[32 + i] + seed;
+	}
+}
+
+// last_stripe is the final 64 bytes of the input, which can overlap stripes that were already accumulated
+template <typename CharType>
+constexpr U64 HashFinishBulk(U64 const* in_acc, CharType const* last_stripe, PtrSize size_bytes)
+{
+	U64 acc[8]{};
+	U64 stripe[8]{};
+	for (S32 i = 0; i < 8; i++)
+	{
+		acc[i] = in_acc[i];
+		stripe[i] = HashRead64(last_stripe + i * 8);
+	}
+	HashAccumulateStripe(acc, stripe, 7);
+
+	U64 result = size_bytes * 0x9E3779B185EBCA87ull;
+	for (S32 i = 0; i < 8; i += 2)
+	{
+		result += HashMum(acc[i] ^ g_hash_secret.values[16 + i], acc[i + 1] ^ g_hash_secret.values[17 + i]);
+	}
+	return HashAvalanche(result);
+}
+
+template <typename CharType>
+constexpr U64 HashBytes(CharType const* data, PtrSize size_bytes, U64 seed)
+{
+	U64 const* const secret = g_hash_secret.values;
+	if (size_bytes <= 16)
+	{
+		U64 a = 0;
+		U64 b = 0;
+		if (size_bytes >= 8)
+		{
+			a = HashRead64(data);
+			b = HashRead64(data + size_bytes - 8);
+		}
+		else if (size_bytes >= 4)
+		{
+			a = HashRead32(data);
+			b = HashRead32(data + size_bytes - 4);
+		}
+		else if (size_bytes > 0)
+		{
+			a = (static_cast<U64>(static_cast<U8>(data[0])) << 16) | (static_cast<U64>(static_cast<U8>(data[size_bytes >> 1])) << 8) |
+				static_cast<U64>(static_cast<U8>(data[size_bytes - 1]));
+		}
+		return HashAvalanche(HashMum(a ^ secret[0] ^ seed, b ^ secret[1] ^ size_bytes));
+	}
+
+	if (size_bytes <= hash_bulk_threshold_bytes)
+	{
+		// The chunks don't depend on each other so the multiplies overlap, the last one may overlap the one before it
+		U64 acc = size_bytes * 0x9E3779B185EBCA87ull;
+		PtrSize offset = 0;
+		for (S32 secret_index = 0; offset + 16 < size_bytes; offset += 16, secret_index += 2)
+		{
+			acc += HashMum(HashRead64(data + offset) ^ (secret[secret_index] + seed), HashRead64(data + offset + 8) ^ (secret[secret_index + 1] - seed));
+		}
+		acc += HashMum(HashRead64(data + size_bytes - 16) ^ (secret[30] + seed), HashRead64(data + size_bytes - 8) ^ (secret[31] - seed));
+		return HashAvalanche(acc);
+	}
+
+	// At least one byte is always left for the last stripe, Hash64Stream relies on that to match this
+	U64 acc[8]{};
+	HashInitAccumulators(acc, seed);
+	U32 block_stripe = 0;
+	HashAccumulate(acc, data, (size_bytes - 1) / hash_stripe_size_bytes, block_stripe);
+	return HashFinishBulk(acc, data + size_bytes - hash_stripe_size_bytes, size_bytes);
+}
+
+U64 Hash64(void const* data, PtrSize size_bytes, U64 seed = 0);
+
+inline U64 Hash64(StringView8 str, U64 seed = 0)
+{
+	return Hash64(str.ptr, str.size_bytes, seed);
+}
+
+// Same value Hash64 gives for the literal's bytes, without the terminator
+template <PtrSize N>
+consteval U64 HashLiteral(char const (&str)[N], U64 seed = 0)
+{
+	return HashBytes(str, N - 1, seed);
+}
+
+// For integer keys and pointers
+constexpr U64 HashU64(U64 value)
+{
+	return HashAvalanche(HashMum(value ^ g_hash_secret.values[2], g_hash_secret.values[3]));
+}
+
+// Order matters, HashCombine(HashCombine(seed, a), b) is different from combining b first. Hash structs field by field
+// with it rather than hashing their bytes, padding is undefined.
+constexpr U64 HashCombine(U64 seed, U64 value)
+{
+	return HashMum(seed ^ g_hash_secret.values[4], value ^ g_hash_secret.values[5]);
+}
+
+// Hashes data fed in pieces, the result is the same as Hash64 over all of it in one go
+class Hash64Stream
+{
+public:
+	explicit Hash64Stream(U64 seed = 0);
+
+	void Update(void const* data, PtrSize size_bytes);
+	U64 Finish() const;
+
+private:
+	U64 acc[8];
+	Byte buffer[hash_bulk_threshold_bytes];
+	// The last stripe that went into the accumulators, the final stripe can reach back into it
+	Byte previous_stripe[hash_stripe_size_bytes];
+	PtrSize total_size_bytes = 0;
+	PtrSize buffered_size_bytes = 0;
+	U64 seed;
+	U32 block_stripe = 0;
+};
@@ -0,0 +1,447 @@
+#pragma once
+
+#include <core/assert.h>
+#include <core/hash.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/string_types.h>
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PAW_HASH_MAP_SSE2 1
+#else
+#define PAW_HASH_MAP_SSE2 0
+#endif
+
+// Hash and equality for keys. The default covers integers and enums, specialize it for other key types.
+template <typename K>
+struct HashMapTraits
+{
+	static U64 Hash(K const& key)
+	{
+		return HashU64(static_cast<U64>(key));
+	}
+
+	static bool Equal(K const& a, K const& b)
+	{
+		return a == b;
+	}
+};
+
+template <typename T>
+struct HashMapTraits<T*>
+{
+	static U64 Hash(T* key)
+	{
+		return HashU64(reinterpret_cast<U64>(key));
+	}
+
+	static bool Equal(T* a, T* b)
+	{
+		return a == b;
+	}
+};
+
+// Compares the bytes, the view doesn't own them so they have to outlive the map
+template <>
+struct HashMapTraits<StringView8>
+{
+	static U64 Hash(StringView8 const& key)
+	{
+		return Hash64(key);
+	}
+
+	static bool Equal(StringView8 const& a, StringView8 const& b)
+	{
+		return a.size_bytes == b.size_bytes && (a.size_bytes == 0 || std::memcmp(a.ptr, b.ptr, a.size_bytes) == 0);
+	}
+};
+
+// A window of control bytes checked at once. Bit i of a mask is set when byte i matched.
+struct HashMapGroup
+{
+	static constexpr S32 width = 16;
+
+#if PAW_HASH_MAP_SSE2
+	explicit HashMapGroup(U8 const* ctrl)
+		: bytes(_mm_loadu_si128(reinterpret_cast<__m128i const*>(ctrl)))
+	{
+	}
+
+	U32 Match(U8 h2) const
+	{
+		return static_cast<U32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), bytes)));
+	}
+
+	// Empty is the only control byte with the top bit set
+	U32 MatchEmpty() const
+	{
+		return static_cast<U32>(_mm_movemask_epi8(bytes));
+	}
+
+	__m128i bytes;
+#else
+	explicit HashMapGroup(U8 const* ctrl)
+	{
+		std::memcpy(bytes, ctrl, width);
+	}
+
+	U32 Match(U8 h2) const
+	{
+		U32 mask = 0;
+		for (S32 i = 0; i < width; i++)
+		{
+			mask |= static_cast<U32>(bytes[i] == h2) << i;
+		}
+		return mask;
+	}
+
+	U32 MatchEmpty() const
+	{
+		U32 mask = 0;
+		for (S32 i = 0; i < width; i++)
+		{
+			mask |= static_cast<U32>(bytes[i] >> 7) << i;
+		}
+		return mask;
+	}
+
+	U8 bytes[width];
+#endif
+};
+
+// Open addressing hash map in the style of a Swiss table. Every slot has a control byte, either empty or the low 7 bits
+// of the key's hash, and a probe checks a whole group of them with a couple of SIMD instructions before any key is
+// compared. Probing is linear in group sized steps, which lets Remove shift the following entries back instead of
+// leaving tombstones, so lookups never slow down after a lot of churn. Removing rehashes the keys it shifts.
+// Values move when the table grows or an entry is removed, so don't hold on to pointers returned by Find.
+template <typename K, typename V, typename Traits = HashMapTraits<K>>
+class HashMap : NonCopyable
+{
+public:
+	HashMap() = default;
+
+	explicit HashMap(IAllocator* allocator, S32 initial_capacity = 0)
+	{
+		Init(allocator, initial_capacity);
+	}
+
+	~HashMap()
+	{
+		Clear();
+		FreeTable();
+	}
+
+	void Init(IAllocator* allocator, S32 initial_capacity = 0)
+	{
+		this->allocator = allocator;
+		Reserve(initial_capacity);
+	}
+
+	V* Find(K const& key)
+	{
+		S32 const index = FindIndex(key, Traits::Hash(key));
+		return index != null_index ? &slots[index].value : nullptr;
+	}
+
+	V const* Find(K const& key) const
+	{
+		S32 const index = FindIndex(key, Traits::Hash(key));
+		return index != null_index ? &slots[index].value : nullptr;
+	}
+
+	bool Contains(K const& key) const
+	{
+		return FindIndex(key, Traits::Hash(key)) != null_index;
+	}
+
+	// Default constructs the value when the key isn't in the map yet
+	V& FindOrAdd(K const& key, bool* out_added = nullptr)
+	{
+		U64 const hash = Traits::Hash(key);
+		S32 index = FindIndex(key, hash);
+		if (out_added)
+		{
+			*out_added = index == null_index;
+		}
+		if (index != null_index)
+		{
+			return slots[index].value;
+		}
+
+		if (count >= growth_limit)
+		{
+			Rehash(capacity > 0 ? capacity * 2 : min_capacity);
+		}
+
+		index = FindEmptyIndex(hash);
+		SetCtrl(index, GetH2(hash));
+		new (&slots[index].key, PlacementNewTag_t{}) K(key);
+		new (&slots[index].value, PlacementNewTag_t{}) V();
+		count++;
+		return slots[index].value;
+	}
+
+	// Adds the key or overwrites the value it already has
+	V& Set(K const& key, V value)
+	{
+		V& slot_value = FindOrAdd(key);
+		slot_value = std::move(value);
+		return slot_value;
+	}
+
+	bool Remove(K const& key)
+	{
+		S32 hole = FindIndex(key, Traits::Hash(key));
+		if (hole == null_index)
+		{
+			return false;
+		}
+
+		DestroySlot(hole);
+
+		// Shift the rest of the run back so no lookup has to step over the hole. An entry can only move into the hole
+		// when the hole lies between its home slot and where it is now.
+		S32 next = (hole + 1) & mask;
+		while (ctrl[next] != ctrl_empty)
+		{
+			S32 const home = GetHomeIndex(Traits::Hash(slots[next].key));
+			if (((next - home) & mask) >= ((next - hole) & mask))
+			{
+				new (&slots[hole].key, PlacementNewTag_t{}) K(std::move(slots[next].key));
+				new (&slots[hole].value, PlacementNewTag_t{}) V(std::move(slots[next].value));
+				DestroySlot(next);
+				SetCtrl(hole, ctrl[next]);
+				hole = next;
+			}
+			next = (next + 1) & mask;
+		}
+
+		SetCtrl(hole, ctrl_empty);
+		count--;
+		return true;
+	}
+
+	// Removes every entry and keeps the table for the next ones
+	void Clear()
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if constexpr (!std::is_trivially_destructible_v<K> || !std::is_trivially_destructible_v<V>)
+		{
+			ForEachIndex([this](S32 index) { DestroySlot(index); });
+		}
+		std::memset(ctrl, ctrl_empty, static_cast<PtrSize>(capacity) + HashMapGroup::width);
+		count = 0;
+	}
+
+	// Grows the table so count entries fit without another rehash
+	void Reserve(S32 new_count)
+	{
+		S32 new_capacity = capacity > 0 ? capacity : min_capacity;
+		while (CalcGrowthLimit(new_capacity) < new_count)
+		{
+			new_capacity *= 2;
+		}
+
+		if (new_count > 0 && new_capacity > capacity)
+		{
+			Rehash(new_capacity);
+		}
+	}
+
+	S32 GetCount() const
+	{
+		return count;
+	}
+
+	S32 GetCapacity() const
+	{
+		return capacity;
+	}
+
+	// Calls func(key, value) for every entry, in no particular order. Adding or removing entries inside func isn't allowed.
+	template <typename Func>
+	void ForEach(Func&& func)
+	{
+		ForEachIndex([this, &func](S32 index) { func(static_cast<K const&>(slots[index].key), slots[index].value); });
+	}
+
+	template <typename Func>
+	void ForEach(Func&& func) const
+	{
+		ForEachIndex([this, &func](S32 index) { func(slots[index].key, static_cast<V const&>(slots[index].value)); });
+	}
+
+private:
+	struct Slot
+	{
+		K key;
+		V value;
+	};
+
+	static constexpr S32 null_index = -1;
+	static constexpr S32 min_capacity = HashMapGroup::width;
+	static constexpr U8 ctrl_empty = 0x80;
+
+	static U8 GetH2(U64 hash)
+	{
+		return static_cast<U8>(hash & 0x7F);
+	}
+
+	S32 GetHomeIndex(U64 hash) const
+	{
+		return static_cast<S32>(hash >> 7) & mask;
+	}
+
+	// At most 7/8 full, past that the runs get long enough to cost more than the memory saved
+	static S32 CalcGrowthLimit(S32 capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	static PtrSize CalcTableSizeBytes(S32 capacity)
+	{
+		// The first group's control bytes are mirrored after the last slot so a group load never wraps
+		return sizeof(Slot) * static_cast<PtrSize>(capacity) + static_cast<PtrSize>(capacity) + HashMapGroup::width;
+	}
+
+	static constexpr PtrSize table_alignment = alignof(Slot) > 16 ? alignof(Slot) : 16;
+
+	S32 FindIndex(K const& key, U64 hash) const
+	{
+		if (count == 0)
+		{
+			return null_index;
+		}
+
+		U8 const h2 = GetH2(hash);
+		S32 position = GetHomeIndex(hash);
+		while (true)
+		{
+			HashMapGroup const group{ctrl + position};
+			for (U32 match = group.Match(h2); match != 0; match &= match - 1)
+			{
+				S32 const index = (position + __builtin_ctz(match)) & mask;
+				if (Traits::Equal(slots[index].key, key))
+				{
+					return index;
+				}
+			}
+
+			// Every slot between an entry's home and the entry is full, so an empty slot ends the search
+			if (group.MatchEmpty() != 0)
+			{
+				return null_index;
+			}
+			position = (position + HashMapGroup::width) & mask;
+		}
+	}
+
+	S32 FindEmptyIndex(U64 hash) const
+	{
+		S32 position = GetHomeIndex(hash);
+		while (true)
+		{
+			U32 const empty = HashMapGroup{ctrl + position}.MatchEmpty();
+			if (empty != 0)
+			{
+				return (position + __builtin_ctz(empty)) & mask;
+			}
+			position = (position + HashMapGroup::width) & mask;
+		}
+	}
+
+	void SetCtrl(S32 index, U8 value)
+	{
+		ctrl[index] = value;
+		if (index < HashMapGroup::width - 1)
+		{
+			ctrl[capacity + index] = value;
+		}
+	}
+
+	template <typename Func>
+	void ForEachIndex(Func&& func) const
+	{
+		for (S32 position = 0; position < capacity; position += HashMapGroup::width)
+		{
+			U32 full = ~HashMapGroup{ctrl + position}.MatchEmpty() & 0xFFFF;
+			for (; full != 0; full &= full - 1)
+			{
+				func(position + __builtin_ctz(full));
+			}
+		}
+	}
+
+	void DestroySlot(S32 index)
+	{
+		slots[index].key.~K();
+		slots[index].value.~V();
+	}
+
+	void Rehash(S32 new_capacity)
+	{
+		MemorySlice const memory = AllocMem(CalcTableSizeBytes(new_capacity), table_alignment, allocator, SrcLoc());
+		PAW_ASSERT(memory.ptr != nullptr, "Failed to grow the hash map");
+
+		Slot* const old_slots = slots;
+		U8* const old_ctrl = ctrl;
+		S32 const old_capacity = capacity;
+
+		slots = reinterpret_cast<Slot*>(memory.ptr);
+		ctrl = memory.ptr + sizeof(Slot) * static_cast<PtrSize>(new_capacity);
+		std::memset(ctrl, ctrl_empty, static_cast<PtrSize>(new_capacity) + HashMapGroup::width);
+		capacity = new_capacity;
+		mask = new_capacity - 1;
+		growth_limit = CalcGrowthLimit(new_capacity);
+
+		if (old_slots == nullptr)
+		{
+			return;
+		}
+
+		for (S32 old_index = 0; old_index < old_capacity; old_index++)
+		{
+			if (old_ctrl[old_index] == ctrl_empty)
+			{
+				continue;
+			}
+
+			Slot& old_slot = old_slots[old_index];
+			U64 const hash = Traits::Hash(old_slot.key);
+			S32 const index = FindEmptyIndex(hash);
+			SetCtrl(index, GetH2(hash));
+			new (&slots[index].key, PlacementNewTag_t{}) K(std::move(old_slot.key));
+			new (&slots[index].value, PlacementNewTag_t{}) V(std::move(old_slot.value));
+			old_slot.key.~K();
+			old_slot.value.~V();
+		}
+
+		PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(old_slots), CalcTableSizeBytes(old_capacity)}));
+	}
+
+	void FreeTable()
+	{
+		if (slots)
+		{
+			PAW_FREE_IN(allocator, (MemorySlice{reinterpret_cast<Byte*>(slots), CalcTableSizeBytes(capacity)}));
+		}
+	}
+
+	IAllocator* allocator = nullptr;
+	Slot* slots = nullptr;
+	U8* ctrl = nullptr;
+	S32 count = 0;
+	S32 capacity = 0;
+	S32 mask = 0;
+	// Adding an entry once count reaches this grows the table first
+	S32 growth_limit = 0;
+};
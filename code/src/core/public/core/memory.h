@@ -8,6 +8,9 @@ void MemoryDeinit();
 
 MemorySlice AllocMem(PtrSize size, PtrSize alignment, IAllocator* allocator, SrcLocation src);
 void FreeMem(MemorySlice slice, IAllocator* allocator, SrcLocation src);
+// Resizes in place when the allocator can, otherwise moves the contents into a new allocation and frees the old one.
+// Returns an empty slice and leaves the old allocation alone if the new one can't be made.
+MemorySlice ResizeMem(MemorySlice slice, PtrSize new_size, PtrSize alignment, IAllocator* allocator, SrcLocation src);
 
 PtrSize CalcAlignmentOffset(Byte* ptr, PtrSize alignment);
 Byte* AlignPointerForward(Byte* ptr, PtrSize alignment);
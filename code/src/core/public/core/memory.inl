@@ -3,14 +3,24 @@
 #include <core/memory.h>
 #include <core/slice.inl>
 
-#define PAW_NEW(type) ::new (alignof(type), nullptr, SrcLoc()) type
-#define PAW_NEW_IN(allocator, type) ::new (alignof(type), allocator, SrcLoc()) type
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Followed by the constructor arguments, PAW_NEW_IN(allocator, Type)(args...). Returns nullptr if the allocation fails
+#define PAW_NEW(type) NewObject<type>{nullptr, SrcLoc()}
+#define PAW_NEW_IN(allocator, type) NewObject<type>{allocator, SrcLoc()}
 #define PAW_NEW_SLICE(count, type) NewSlice<type>(count, nullptr, SrcLoc())
 #define PAW_NEW_SLICE_IN(allocator, count, type) NewSlice<type>(count, allocator, SrcLoc())
+// Leaves the items uninitialized, for buffers that get completely overwritten straight away
+#define PAW_NEW_SLICE_UNINIT(count, type) NewSliceUninit<type>(count, nullptr, SrcLoc())
+#define PAW_NEW_SLICE_UNINIT_IN(allocator, count, type) NewSliceUninit<type>(count, allocator, SrcLoc())
 #define PAW_NEW_SLICE_2D_IN(allocator, row_count, column_count, type) NewSlice2D<type>(row_count, column_count, allocator, SrcLoc())
 #define PAW_NEW_SLICE_2D(row_count, column_count, type) PAW_NEW_SLICE_2D_IN(nullptr, row_count, column_count, type)
 #define PAW_ALLOC_IN(allocator, size_bytes) AllocMem(size_bytes, 1, allocator, SrcLoc())
 #define PAW_ALLOC(size_bytes) PAW_ALLOC_IN(nullptr, size_bytes)
+#define PAW_RESIZE_IN(allocator, memory, size_bytes, alignment) ResizeMem(memory, size_bytes, alignment, allocator, SrcLoc())
+#define PAW_RESIZE(memory, size_bytes, alignment) PAW_RESIZE_IN(nullptr, memory, size_bytes, alignment)
 
 #define PAW_DELETE(ptr) Delete(ptr, nullptr, SrcLoc())
 #define PAW_DELETE_IN(allocator, ptr) Delete(ptr, allocator, SrcLoc())
@@ -23,17 +33,6 @@
 
 #pragma region implementation
 
-inline void* operator new(size_t size, PtrSize alignment, IAllocator* allocator, SrcLocation src_loc) noexcept
-{
-	MemorySlice mem = AllocMem(size, alignment, allocator, src_loc);
-	return mem.ptr;
-}
-
-inline void operator delete(void*, PtrSize, IAllocator*, SrcLocation) noexcept
-{
-	PAW_ASSERT(false, "operator delete shouldn't be called");
-}
-
 struct PlacementNewTag_t
 {
 };
@@ -47,6 +46,25 @@ constexpr void operator delete(void*, void*, PlacementNewTag_t) noexcept
 {
 }
 
+template <typename T>
+struct NewObject
+{
+	IAllocator* allocator;
+	SrcLocation src;
+
+	template <typename... ArgTypes>
+	T* operator()(ArgTypes&&... args) const
+	{
+		MemorySlice mem = AllocMem(sizeof(T), alignof(T), allocator, src);
+		if (mem.ptr == nullptr)
+		{
+			return nullptr;
+		}
+
+		return new (mem.ptr, PlacementNewTag_t{}) T(std::forward<ArgTypes>(args)...);
+	}
+};
+
 template <typename T>
 void Delete(T* t, IAllocator* allocator, SrcLocation src)
 {
@@ -60,23 +78,60 @@ void Delete(T& t, IAllocator* allocator, SrcLocation src)
 	Delete(&t, allocator, src);
 }
 
+// Value initializes count items. For trivial types that's all zeroes, so they get one memset instead of a loop.
+template <typename T>
+inline void ConstructItems(Byte* ptr, S32 count)
+{
+	if constexpr (std::is_trivially_default_constructible_v<T>)
+	{
+		std::memset(ptr, 0, sizeof(T) * count);
+	}
+	else
+	{
+		for (S32 i = 0; i < count; i++)
+		{
+			new (ptr + i * sizeof(T), PlacementNewTag_t{}) T();
+		}
+	}
+}
+
 template <typename T>
 inline Slice<T> NewSlice(S32 count, IAllocator* allocator, SrcLocation src)
 {
 	MemorySlice mem = AllocMem(sizeof(T) * count, alignof(T), allocator, src);
-	for (S32 i = 0; i < count; i++)
+	if (mem.ptr == nullptr)
+	{
+		return {};
+	}
+
+	ConstructItems<T>(mem.ptr, count);
+	return Slice<T>{reinterpret_cast<T*>(mem.ptr), count};
+}
+
+template <typename T>
+inline Slice<T> NewSliceUninit(S32 count, IAllocator* allocator, SrcLocation src)
+{
+	// Objects of these types come into existence by writing their bytes, so skipping the constructor is fine
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "Only types that don't need constructing can be allocated uninitialized");
+
+	MemorySlice mem = AllocMem(sizeof(T) * count, alignof(T), allocator, src);
+	if (mem.ptr == nullptr)
 	{
-		new (mem.ptr + i * sizeof(T), PlacementNewTag_t{}) T();
+		return {};
 	}
+
 	return Slice<T>{reinterpret_cast<T*>(mem.ptr), count};
 }
 
 template <typename T>
 void DeleteSlice(Slice<T> slice, IAllocator* allocator, SrcLocation src)
 {
-	for (T& item : slice)
+	if constexpr (!std::is_trivially_destructible_v<T>)
 	{
-		item.~T();
+		for (T& item : slice)
+		{
+			item.~T();
+		}
 	}
 
 	FreeMem(MemorySlice{reinterpret_cast<Byte*>(slice.items), CalcTotalSizeBytes(slice)}, allocator, src);
@@ -87,21 +142,26 @@ inline Slice2D<T> NewSlice2D(S32 row_count, S32 column_count, IAllocator* alloca
 {
 	S32 const count = row_count * column_count;
 	MemorySlice mem = AllocMem(sizeof(T) * count, alignof(T), allocator, src);
-	for (S32 i = 0; i < count; i++)
+	if (mem.ptr == nullptr)
 	{
-		new (mem.ptr + i * sizeof(T), PlacementNewTag_t{}) T();
+		return {};
 	}
+
+	ConstructItems<T>(mem.ptr, count);
 	return Slice2D<T>{reinterpret_cast<T*>(mem.ptr), row_count, column_count};
 }
 
 template <typename T>
 void DeleteSlice2D(Slice2D<T> slice, IAllocator* allocator, SrcLocation src)
 {
-	for (S32 row_index = 0; row_index < slice.row_count; row_index++)
+	if constexpr (!std::is_trivially_destructible_v<T>)
 	{
-		for (S32 col_index = 0; col_index < slice.column_count; col_index++)
+		for (S32 row_index = 0; row_index < slice.row_count; row_index++)
 		{
-			slice[row_index][col_index].~T();
+			for (S32 col_index = 0; col_index < slice.column_count; col_index++)
+			{
+				slice[row_index][col_index].~T();
+			}
 		}
 	}
 
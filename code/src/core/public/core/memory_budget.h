@@ -0,0 +1,30 @@
+#pragma once
+
+#include <core/memory_types.h>
+
+// Committed memory budgets, globally and per MemoryCategory. Every page an allocator commits is counted against its
+// category and the global total. Limits of 0 are unlimited.
+//
+// Going over a hard limit fails the commit, so the allocation that needed it returns an empty MemorySlice.
+// Crossing a soft limit calls the callback once on the way up, from inside the allocation that crossed it. The callback
+// must not allocate from or trim that allocator, it should flag the owning subsystem to trim at a safe point instead.
+
+using MemoryBudgetCallback = void (*)(MemoryCategory category, PtrSize committed_bytes, void* user_data);
+
+struct MemoryBudget
+{
+	PtrSize soft_limit_bytes = 0;
+	PtrSize hard_limit_bytes = 0;
+	MemoryBudgetCallback on_soft_limit = nullptr;
+	void* user_data = nullptr;
+};
+
+// Set these up before the allocators they cover start committing
+void MemorySetCategoryBudget(MemoryCategory category, MemoryBudget budget);
+// The callback gets MemoryCategory::Count as the category
+void MemorySetTotalBudget(MemoryBudget budget);
+
+PtrSize MemoryGetCommittedBytes();
+PtrSize MemoryGetCommittedBytes(MemoryCategory category);
+
+char const* GetMemoryCategoryName(MemoryCategory category);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <core/memory_types.h>
+#include <core/slice_types.h>
+#include <core/src_location_types.h>
+
+// Opt-in allocation tracking. While it's running, AllocMem/FreeMem and the allocators' page level AllocPages/FreePages
+// append events to a small per-thread buffer without taking a lock. When a buffer fills up or its thread exits, only that
+// thread's events are handed over. MemoryTrackingFlush also picks up what every other thread has buffered so far. Events
+// are applied to the shared tables sorted by a global sequence number and only once nothing that happened before them
+// can still turn up, so a Free on one thread always finds the allocation another thread made. Queries flush first.
+// Allocations that bypass AllocMem, e.g. calling IAllocator::Alloc directly, only show up in the page stats.
+// Compiled out in PAW_RETAIL.
+
+struct MemoryCallsiteStats
+{
+	SrcLocation src;
+	U64 allocation_count = 0;
+	U64 free_count = 0;
+	U64 total_bytes = 0;
+	U64 live_bytes = 0;
+	U64 peak_live_bytes = 0;
+};
+
+struct MemoryAllocatorStats
+{
+	S32 allocator_index = -1;
+	U64 allocation_count = 0;
+	U64 live_bytes = 0;
+	U64 peak_live_bytes = 0;
+	// Pages the allocator is using, retained pages it has given back still count as committed
+	U64 page_bytes = 0;
+	U64 peak_page_bytes = 0;
+	U64 committed_bytes = 0;
+	U64 peak_committed_bytes = 0;
+};
+
+void MemoryTrackingStart();
+void MemoryTrackingStop();
+bool MemoryTrackingIsRunning();
+
+// Clears every table, including the live allocation map, without changing whether tracking is running
+void MemoryTrackingReset();
+void MemoryTrackingFlush();
+
+// Snapshots are copied into the passed in allocator
+Slice<MemoryCallsiteStats> MemoryTrackingGetCallsites(IAllocator* allocator);
+Slice<MemoryAllocatorStats> MemoryTrackingGetAllocators(IAllocator* allocator);
+// Frees of pointers the tracker never saw allocated, e.g. allocated before MemoryTrackingStart
+U64 MemoryTrackingGetUntrackedFreeCount();
+// Allocations recorded at the address of one still live, the earlier one was released without the tracker seeing it
+U64 MemoryTrackingGetOverwrittenAllocationCount();
+
+bool MemoryTrackingWriteJson(char const* path);
+bool MemoryTrackingWriteCallsitesCsv(char const* path);
+bool MemoryTrackingWriteAllocatorsCsv(char const* path);
@@ -8,29 +8,96 @@ struct MemorySlice
 	PtrSize size_bytes = 0;
 };
 
+enum class PageMode : U8
+{
+	Small,		  // 64 KiB pages
+	Huge,		  // 2 MiB pages, backed by transparent huge pages where the platform supports them
+	ExplicitHuge, // 2 MiB pages from the explicit huge page pool (MAP_HUGETLB), falls back to Huge when it's empty
+};
+
+struct PageConfig
+{
+	PageMode mode = PageMode::Small;
+	// Fault every page in when it's committed instead of on first touch
+	bool prefault = false;
+};
+
+// Subsystem an allocator's committed pages are counted against, see memory_budget.h
+enum class MemoryCategory : U8
+{
+	General,
+	RenderGraph,
+	UI,
+	ECS,
+	Fonts,
+	Temp,
+	Count,
+};
+
+// What happens to committed pages when an allocator gives them back through FreePages/FreeAllPages. The default
+// decommits straight away. Pages that are kept are handed out again without zeroing.
+struct RetentionPolicy
+{
+	// Committed bytes that are never decommitted until the allocator is destroyed
+	PtrSize keep_committed_bytes = 0;
+	// When non-zero, pages above keep_committed_bytes stay committed until this many FreeAllPages calls in a row have
+	// peaked below the committed size. They are then trimmed down to the last peak. Meant for arenas reset every frame.
+	S32 decommit_after_frames = 0;
+};
+
 class IAllocator : NonCopyable
 {
 public:
 	// Don't call these directly! Go through the PAW_NEW/DELETE tracking macros
 	virtual MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) = 0;
 	virtual void Free(MemorySlice memory) = 0;
+	// Grows or shrinks the allocation without moving it. On success the memory at memory.ptr is valid for new_size_bytes,
+	// on failure nothing changes. The default can't resize anything.
+	virtual bool TryResize(MemorySlice memory, PtrSize new_size_bytes);
+
+	// Index of the slot this allocator is registered in, stable for the allocator's lifetime
+	S32 GetAllocatorIndex() const;
+
+	void SetRetentionPolicy(RetentionPolicy policy);
+	PtrSize GetCommittedBytes() const;
+
+	// Moves the pages this allocator already has committed over to the new category
+	void SetMemoryCategory(MemoryCategory category);
+	MemoryCategory GetMemoryCategory() const;
+	// Commits that would take this allocator past the limit fail and the allocation returns an empty MemorySlice. 0 is unlimited
+	void SetCommitLimit(PtrSize limit_bytes);
 
 protected:
-	IAllocator();
+	IAllocator(PageConfig page_config = {});
 	virtual ~IAllocator();
 
-	void AllocPages(PtrSize count);
+	// Returns false when the commit would go over the allocator's, its category's or the global hard limit
+	bool AllocPages(PtrSize count);
 	void FreePages(PtrSize count);
 	void FreeAllPages();
+	// Drops the physical memory behind count pages starting at ptr, for free ranges in the middle of the allocator's
+	// memory. They stay committed and are counted as such, the contents are undefined afterwards.
+	void PurgePages(Byte* ptr, PtrSize count);
 	PtrSize CalcMemorySizeBytes();
 
 	PtrSize GetPageCount() const;
 	Byte* GetBaseAddress() const;
 
-	static PtrSize GetPageSize();
-	static PtrSize CalcPageCountFromSize(PtrSize size_bytes);
+	PtrSize GetPageSize() const;
+	PtrSize CalcPageCountFromSize(PtrSize size_bytes) const;
 
 private:
+	void DecommitPagesAbove(PtrSize retained_page_count);
+
 	PtrSize page_count = 0;
+	PtrSize committed_page_count = 0;
+	PtrSize peak_page_count = 0;
+	S32 frames_below_committed = 0;
+	RetentionPolicy retention_policy{};
+	PtrSize commit_limit_bytes = 0;
+	MemoryCategory category = MemoryCategory::General;
 	Byte* base_address = nullptr;
+	PtrSize page_size_bytes = 0;
+	U32 page_shift_count = 0;
+	U32 commit_flags = 0;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <core/slice_types.h>
+#include <core/string_id.h>
 #include <core/string_types.h>
 #include <core/memory_types.h>
 #include <core/math_types.h>
@@ -9,16 +10,28 @@ typedef void JobQueueFunc(void* data);
 
 struct JobDecl
 {
-	StringView8 name = PAW_STR("Unknown Job");
+	StringId name = PAW_SID("Unknown Job");
 	void* data = nullptr;
 	JobQueueFunc* func = nullptr;
 };
 
 void ScheduleJobs(Slice<JobDecl const>&& jobs);
 
+enum PlatformCommitFlags : U32
+{
+	PlatformCommitFlags_None = 0,
+	PlatformCommitFlags_HugePages = 1 << 0,
+	PlatformCommitFlags_ExplicitHugePages = 1 << 1,
+	PlatformCommitFlags_Prefault = 1 << 2,
+};
+
 Byte* PlatformReserveAddressSpace(PtrSize size_bytes);
-void PlatformCommitAddressSpace(Byte* start_ptr, PtrSize size_bytes);
-void PlatformDecommitAddressSpace(Byte* start_ptr, PtrSize size_bytes);
+// Ranges committed with huge page flags need to be 2 MiB aligned and decommitted with the same flags
+void PlatformCommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 flags = PlatformCommitFlags_None);
+void PlatformDecommitAddressSpace(Byte* start_ptr, PtrSize size_bytes, U32 flags = PlatformCommitFlags_None);
+// Hands the physical pages behind a committed range back to the OS while the range stays committed and accessible. The
+// contents are undefined afterwards.
+void PlatformPurgeAddressSpace(Byte* start_ptr, PtrSize size_bytes);
 
 namespace Platform
 {
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <core/arena.h>
+#include <core/memory.h>
+#include <core/memory_types.h>
+
+// Every thread owns a pair of scratch arenas, created the first time the thread opens a ScratchScope. A scope hands out
+// whichever arena isn't the conflicting allocator and rewinds it to where it was when the scope closes.
+// A function that builds its result in an allocator its caller got from a ScratchScope passes that allocator in as the
+// conflict, so its own temporaries never end up in the same arena as the result and get rewound from under it.
+// When the outermost scope on an arena closes, pages past keep_committed_bytes are decommitted.
+class ScratchScope : NonCopyable
+{
+public:
+	static constexpr PtrSize keep_committed_bytes = MegaBytes(1);
+
+	explicit ScratchScope(IAllocator* conflict = nullptr);
+	~ScratchScope();
+
+	ArenaAllocator* GetAllocator() const;
+
+private:
+	ArenaAllocator* arena = nullptr;
+	ArenaMarker_t marker{};
+	S32 arena_index = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <core/memory.h>
+#include <core/memory_types.h>
+
+// Allocator for fixed size nodes that come and go one at a time. Every allocation gets a slot of the same size, freed
+// slots go on an intrusive free list so Alloc and Free are a pop and a push. Slots are carved from the allocator's own
+// pages in order and more pages are committed as they run out.
+// Slots up to a cache line are rounded up to a power of two so none of them straddles a line, bigger ones are packed
+// at their alignment.
+class SlabAllocator final : public IAllocator
+{
+public:
+	SlabAllocator(PtrSize slot_size_bytes, PtrSize slot_alignment = 16, PageConfig page_config = {});
+	~SlabAllocator();
+
+	// Anything up to the slot size and alignment fits, bigger requests assert and return an empty MemorySlice
+	MemorySlice Alloc(PtrSize size_Bytes, PtrSize alignment) override;
+	void Free(MemorySlice memory) override;
+	// Any size that fits in the slot
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
+
+	void FreeAll();
+
+	PtrSize GetSlotStrideBytes() const;
+	S32 GetLiveSlotCount() const;
+
+	static constexpr PtrSize cache_line_size = 64;
+
+private:
+	struct FreeSlot
+	{
+		FreeSlot* next;
+	};
+
+	FreeSlot* free_list = nullptr;
+	// Slots below this offset have been handed out at least once
+	PtrSize carved_Bytes = 0;
+	PtrSize slot_stride_Bytes = 0;
+	PtrSize slot_alignment_bytes = 0;
+	S32 live_slot_count = 0;
+};
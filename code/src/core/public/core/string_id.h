@@ -0,0 +1,77 @@
+#pragma once
+
+#include <core/hash.h>
+#include <core/std.h>
+#include <core/string_types.h>
+
+// 32-bit name for a string, comparing or hashing two of them is an integer operation. The id is the string's hash folded
+// down to 32 bits, so the id of a literal is known at compile time and the same string always gets the same id in every
+// run. The global intern table is there to catch two different strings landing on the same id and to turn ids back into
+// strings for debug output. Interning is lock free and interned strings live until the process exits. The table is set up
+// by MemoryInit, so outside PAW_RETAIL PAW_SID can't be used in static initializers.
+struct StringId
+{
+	// 0 is the empty string
+	U32 value = 0;
+};
+
+constexpr bool operator==(StringId a, StringId b)
+{
+	return a.value == b.value;
+}
+
+constexpr U32 StringIdFoldHash(U64 hash, PtrSize size_bytes)
+{
+	if (size_bytes == 0)
+	{
+		return 0;
+	}
+
+	U32 const id = static_cast<U32>(hash ^ (hash >> 32));
+	return id != 0 ? id : 1;
+}
+
+// Doesn't touch the table, use PAW_SID so the literal can be looked up again
+template <PtrSize N>
+consteval StringId StringIdFromLiteral(char const (&str)[N])
+{
+	return {StringIdFoldHash(HashLiteral(str), N - 1)};
+}
+
+StringId StringIdIntern(StringView8 str);
+// Strings that were never interned come back as "<unknown StringId>"
+StringView8 StringIdGetString(StringId id);
+S32 StringIdGetCount();
+
+// Interns the literal the first time it's used so StringIdGetString can find it, the id itself is a constant
+template <U32 id, PtrSize N>
+inline StringId StringIdRegisterLiteral(char const (&str)[N])
+{
+	static StringId const registered_id = StringIdIntern({.ptr = reinterpret_cast<Byte const*>(str), .size_bytes = N - 1});
+	PAW_UNUSED_ARG(registered_id);
+	return {id};
+}
+
+#if !defined(PAW_RETAIL)
+#define PAW_SID(str) StringIdRegisterLiteral<StringIdFromLiteral(str).value>(str)
+#else
+#define PAW_SID(str) StringIdFromLiteral(str)
+#endif
+
+template <typename K>
+struct HashMapTraits;
+
+// The id is already a hash, HashMap can use it as is
+template <>
+struct HashMapTraits<StringId>
+{
+	static U64 Hash(StringId key)
+	{
+		return key.value;
+	}
+
+	static bool Equal(StringId a, StringId b)
+	{
+		return a == b;
+	}
+};
@@ -1,34 +1,153 @@
 #pragma once
 
+#include <core/memory.h>
 #include <core/memory_types.h>
+#include <core/slice_types.h>
+
+#include <atomic>
+#include <mutex>
+
+// How much free memory a TLSFAllocator hands back to the OS when blocks are freed. Thresholds of 0 turn the release off.
+struct TLSFReleasePolicy
+{
+	// A free block at the end of the heap at least this big gets its pages released through FreePages, which still applies
+	// the allocator's RetentionPolicy
+	PtrSize trailing_release_threshold_bytes = MegaBytes(64);
+	// Free bytes left committed at the end of the heap after a release, so a heap hovering around one size doesn't keep
+	// committing and releasing the same pages
+	PtrSize trailing_keep_bytes = MegaBytes(16);
+	// Free blocks in the middle of the heap at least this big get their whole pages purged, they stay committed. Off by
+	// default, reusing purged pages faults every one of them back in.
+	PtrSize interior_purge_threshold_bytes = 0;
+};
+
+struct TLSFStats;
 
 class TLSFAllocator : public IAllocator
 {
 public:
-	TLSFAllocator();
+	TLSFAllocator(PageConfig page_config = {});
 	~TLSFAllocator();
 
+	void SetReleasePolicy(TLSFReleasePolicy policy);
+
 	MemorySlice Alloc(PtrSize size_bytes, PtrSize alignment) override;
 	void Free(MemorySlice memory) override;
+	// Grows into the physically next block when it's free, shrinking hands the tail back as a free block
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
 
-	void Print();
+	// Reads counters Alloc and Free keep up to date plus one free list, cheap enough to sample every frame
+	virtual TLSFStats GetStats() const;
+	// Free blocks in each bin, indexed by top_level * sub_bin_count + second_level
+	Slice<U32 const> GetFreeBinBlockCounts() const;
+	// Walks every block and free list and checks them against each other and the counters. Slow, meant for tests and
+	// debug checks. Returns false at the first broken invariant.
+	virtual bool VerifyHeap() const;
 
 	struct CommonBlock;
 	struct FreeBlock;
 
 	static constexpr S32 second_level_index = 5; // log2(sub_bin_count);
-private:
-	void InsertBlock(MemorySlice block, U64 prev_physical_block);
-	void RemoveBlock(FreeBlock const* const block);
-
 	static constexpr S32 top_level_count = 63;
 	static constexpr S32 sub_bin_count = 1 << second_level_index;
 	static constexpr S32 second_level_count = top_level_count * sub_bin_count;
 
+private:
+	void InsertBlock(MemorySlice block, U64 prev_physical_block);
+	void RemoveBlock(FreeBlock const* const block);
+	// Applies the release policy to a block Free just inserted. Only the pages overlapping [dirty_begin, dirty_end) can
+	// hold anything, the rest of the block was already purged.
+	void ReleaseFreePages(FreeBlock* block, Byte* dirty_begin, Byte* dirty_end);
+
 	U64 top_level_bitmap = 0;
 	U32 second_level_bitmaps[top_level_count]{};
 	FreeBlock* second_level_pointers[second_level_count]{};
 	CommonBlock* last_physical_block = nullptr;
+	TLSFReleasePolicy release_policy{};
+
+	PtrSize free_bytes = 0;
+	S32 free_block_count = 0;
+	S32 used_block_count = 0;
+	U32 free_bin_block_counts[second_level_count]{};
 
 	static_assert(sizeof(second_level_bitmaps[0]) * 8 == sub_bin_count);
-};
\ No newline at end of file
+};
+
+// Sizes include block headers and alignment padding, free_bytes + used_bytes is everything the heap has grown to
+struct TLSFStats
+{
+	PtrSize free_bytes = 0;
+	PtrSize used_bytes = 0;
+	PtrSize largest_free_block_bytes = 0;
+	S32 free_block_count = 0;
+	S32 used_block_count = 0;
+	// Part of used_bytes, blocks sitting in thread caches ready to be handed out again. Always 0 without thread caches.
+	PtrSize cached_bytes = 0;
+	// 1 - largest_free_block_bytes / free_bytes. 0 when the free memory is one block, towards 1 the more it's scattered
+	F32 external_fragmentation = 0.0f;
+	S32 top_level_free_block_counts[TLSFAllocator::top_level_count]{};
+};
+
+// TLSF behind per-thread magazines of small blocks so worker threads rarely touch the shared heap. Allocations up to
+// max_cached_size_bytes with at most 16 byte alignment come out of the calling thread's magazine for their size class,
+// refilled from and flushed back to the heap in batches under a lock. Everything else goes to the heap under the same
+// lock. Frees that can't get the lock are queued lock-free and handed back by whoever holds it next.
+// Up to max_cached_thread_count threads get magazines at once, the rest always go through the lock.
+// Cached blocks are still allocated as far as the heap is concerned, so they count as used and can keep the end of the
+// heap from being released. TrimCaches hands back the calling thread's magazines, the magazines of threads that have
+// exited and the deferred frees. Magazines of threads that are still running are only ever touched by those threads
+// and stay cached until they refill or flush them. Nothing trims on its own, the owner calls TrimCaches once a frame
+// from the thread that runs the frame loop.
+class ThreadCachingTLSFAllocator final : public TLSFAllocator
+{
+public:
+	ThreadCachingTLSFAllocator(PageConfig page_config = {});
+	~ThreadCachingTLSFAllocator();
+
+	MemorySlice Alloc(PtrSize size_bytes, PtrSize alignment) override;
+	void Free(MemorySlice memory) override;
+	bool TryResize(MemorySlice memory, PtrSize new_size_bytes) override;
+
+	// Returns cached and deferred blocks to the heap, see the class comment for what stays cached. Frees go through the
+	// release policy as usual, so a trim can release the end of the heap.
+	void TrimCaches();
+
+	// Neither touches the caches, cached blocks count as used and show up in TLSFStats::cached_bytes
+	TLSFStats GetStats() const override;
+	bool VerifyHeap() const override;
+
+	static constexpr PtrSize max_cached_size_bytes = 256;
+	static constexpr S32 max_cached_thread_count = 64;
+
+private:
+	static constexpr S32 size_class_count = 16;
+	static constexpr S32 magazine_capacity = 64;
+	// Refills and flushes move half a magazine at a time
+	static constexpr S32 batch_count = magazine_capacity / 2;
+
+	struct Magazine
+	{
+		Byte* blocks[magazine_capacity];
+		// Only the owning thread and TrimCaches write it, GetStats reads it from other threads
+		std::atomic<S32> count;
+	};
+
+	struct ThreadCache
+	{
+		Magazine magazines[size_class_count];
+	};
+
+	struct DeferredFree
+	{
+		DeferredFree* next;
+	};
+
+	ThreadCache* GetThreadCache();
+	void FlushBatch(Magazine& magazine);
+	// Only call while holding heap_mutex
+	void FreeDeferred();
+
+	mutable std::mutex heap_mutex;
+	std::atomic<DeferredFree*> deferred_free_head = nullptr;
+	std::atomic<ThreadCache*> thread_caches[max_cached_thread_count]{};
+};
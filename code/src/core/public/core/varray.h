@@ -0,0 +1,202 @@
+#pragma once
+
+#include <core/arena.h>
+#include <core/assert.h>
+#include <core/memory.h>
+#include <core/memory.inl>
+#include <core/slice_types.h>
+
+#include <type_traits>
+#include <utility>
+
+// Growable array that never moves its items. It owns an arena, so it reserves a whole allocator slot worth of address
+// space up front and only commits pages as it grows. Pointers to items stay valid until they're popped or the array is
+// released, and growing never copies anything. Each VArray takes one of the allocator slots, so keep them for long lived
+// arrays whose worst case size is hard to guess rather than for every small list.
+template <typename T>
+class VArray : NonCopyable
+{
+public:
+	// Capacity is committed in steps of this many bytes, the arena rounds each step up to whole pages
+	static constexpr PtrSize growth_step_bytes = KiloBytes(64);
+
+	VArray() = default;
+
+	explicit VArray(IAllocator* allocator, PageConfig page_config = {})
+	{
+		Init(allocator, page_config);
+	}
+
+	~VArray()
+	{
+		Release();
+		if (arena)
+		{
+			PAW_DELETE_IN(allocator, arena);
+		}
+	}
+
+	// The arena itself comes out of the passed in allocator, the items don't
+	void Init(IAllocator* allocator, PageConfig page_config = {})
+	{
+		PAW_ASSERT(arena == nullptr, "VArray is already initialized");
+		this->allocator = allocator;
+		arena = PAW_NEW_IN(allocator, ArenaAllocator)(page_config);
+	}
+
+	template <typename... ArgTypes>
+	T& PushBack(ArgTypes&&... args)
+	{
+		T* const item = TryPushBack(std::forward<ArgTypes>(args)...);
+		PAW_ASSERT(item != nullptr, "VArray ran out of address space or went over its commit limit");
+		return *item;
+	}
+
+	// Returns nullptr and leaves the array as it was if the pages for the item can't be committed
+	template <typename... ArgTypes>
+	T* TryPushBack(ArgTypes&&... args)
+	{
+		if (count == capacity && !Grow(count + 1))
+		{
+			return nullptr;
+		}
+
+		T* const item = new (items + count, PlacementNewTag_t{}) T(std::forward<ArgTypes>(args)...);
+		count++;
+		return item;
+	}
+
+	void PopBack()
+	{
+		PAW_ASSERT(count > 0, "VArray is empty");
+		count--;
+		items[count].~T();
+	}
+
+	// Commits enough pages for at least new_capacity items, returns false and keeps the old capacity if it can't
+	bool Reserve(S32 new_capacity)
+	{
+		return new_capacity <= capacity || Grow(new_capacity);
+	}
+
+	// Destroys every item but keeps the pages committed for the next pushes
+	void Clear()
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			for (S32 i = 0; i < count; i++)
+			{
+				items[i].~T();
+			}
+		}
+		count = 0;
+	}
+
+	// Destroys every item and hands the pages back to the arena's retention policy
+	void Release()
+	{
+		Clear();
+		if (arena)
+		{
+			arena->FreeAll();
+		}
+		items = nullptr;
+		items_size_bytes = 0;
+		capacity = 0;
+	}
+
+	T& operator[](S32 index)
+	{
+		PAW_ASSERT(index >= 0 && index < count, "Index is not in range");
+		return items[index];
+	}
+
+	T const& operator[](S32 index) const
+	{
+		PAW_ASSERT(index >= 0 && index < count, "Index is not in range");
+		return items[index];
+	}
+
+	S32 GetCount() const
+	{
+		return count;
+	}
+
+	S32 GetCapacity() const
+	{
+		return capacity;
+	}
+
+	Slice<T> GetItems()
+	{
+		return {items, count};
+	}
+
+	Slice<T const> GetItems() const
+	{
+		return {items, count};
+	}
+
+	// For setting the memory category, retention policy or commit limit of the pages behind the items
+	IAllocator* GetArena() const
+	{
+		return arena;
+	}
+
+	T* begin()
+	{
+		return items;
+	}
+
+	T* end()
+	{
+		return items + count;
+	}
+
+	T const* begin() const
+	{
+		return items;
+	}
+
+	T const* end() const
+	{
+		return items + count;
+	}
+
+private:
+	bool Grow(S32 min_capacity)
+	{
+		PAW_ASSERT(arena != nullptr, "VArray is not initialized");
+
+		PtrSize const max_capacity = g_s32_max;
+		PtrSize const new_size_bytes = AlignSizeForward(sizeof(T) * static_cast<PtrSize>(min_capacity), growth_step_bytes);
+		PtrSize const new_capacity = new_size_bytes / sizeof(T) < max_capacity ? new_size_bytes / sizeof(T) : max_capacity;
+
+		// The items are the only allocation in the arena, so resizing them only ever commits pages past the end
+		if (items == nullptr)
+		{
+			T* const new_items = reinterpret_cast<T*>(arena->Alloc(new_size_bytes, alignof(T)).ptr);
+			if (new_items == nullptr)
+			{
+				return false;
+			}
+			items = new_items;
+		}
+		else if (!arena->TryResize({reinterpret_cast<Byte*>(items), items_size_bytes}, new_size_bytes))
+		{
+			return false;
+		}
+
+		items_size_bytes = new_size_bytes;
+		capacity = static_cast<S32>(new_capacity);
+		return true;
+	}
+
+	IAllocator* allocator = nullptr;
+	ArenaAllocator* arena = nullptr;
+	T* items = nullptr;
+	// Size of the arena allocation, a step isn't always a whole number of items
+	PtrSize items_size_bytes = 0;
+	S32 count = 0;
+	S32 capacity = 0;
+};
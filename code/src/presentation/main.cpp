@@ -4,6 +4,7 @@
 #include <core/logger.h>
 #include <core/memory.inl>
 #include <core/arena.h>
+#include <core/hash_map.h>
 #include <core/math.h>
 #include <core/platform.h>
 
@@ -33,7 +34,7 @@ struct SceneViewPass : Gfx::GraphExecutor
 	Gfx::Texture texture;
 	Gfx::Sampler sampler;
 
-	static SceneViewPass const& Build(Gfx::GraphBuilder& builder, StringView8 name, S32 width, S32 height, Gfx::Pipeline pso, Float3 color, Gfx::Texture texture, Gfx::Sampler sampler)
+	static SceneViewPass const& Build(Gfx::GraphBuilder& builder, StringId name, S32 width, S32 height, Gfx::Pipeline pso, Float3 color, Gfx::Texture texture, Gfx::Sampler sampler)
 	{
 		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, name);
 		SceneViewPass& data = Gfx::GraphSetExecutor<SceneViewPass>(builder, pass);
@@ -42,7 +43,7 @@ struct SceneViewPass : Gfx::GraphExecutor
 																   width,
 																   height,
 																   Gfx::Format::R16G16B16A16_Float,
-																   PAW_STR("Scene Color RT"),
+																   PAW_SID("Scene Color RT"),
 																   Gfx::InitialState::Clear,
 																   {.color = {0.33f, 0.33f, 0.33f, 1.0f}},
 															   });
@@ -51,7 +52,7 @@ struct SceneViewPass : Gfx::GraphExecutor
 																	width,
 																	height,
 																	Gfx::Format::R16G16B16A16_Float,
-																	PAW_STR("Scene Color1 RT"),
+																	PAW_SID("Scene Color1 RT"),
 																	Gfx::InitialState::Clear,
 																	{.color = {1.0f, 1.0f, 1.0f, 1.0f}},
 																});
@@ -60,7 +61,7 @@ struct SceneViewPass : Gfx::GraphExecutor
 																   width,
 																   height,
 																   Gfx::Format::Depth32_Float,
-																   PAW_STR("Scene Depth RT"),
+																   PAW_SID("Scene Depth RT"),
 																   Gfx::InitialState::Clear,
 																   {.depth_stencil = {.depth = 0.0f, .stencil = 0}},
 															   });
@@ -118,7 +119,7 @@ struct BlitPass : Gfx::GraphExecutor
 
 	static BlitPass const& Build(Gfx::GraphBuilder& builder, Gfx::GraphTexture output_texture, Gfx::GraphTexture input_texture, Gfx::Sampler sampler, Gfx::Pipeline pso)
 	{
-		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_STR("Blit"));
+		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_SID("Blit"));
 		BlitPass& data = Gfx::GraphSetExecutor<BlitPass>(builder, pass);
 		data.input_texture = Gfx::GraphReadTexture(builder, pass, input_texture, Gfx::Access::PixelShader);
 		data.backbuffer = Gfx::GraphWriteTexture(builder, pass, output_texture, Gfx::Access::RenderTarget);
@@ -168,14 +169,15 @@ struct UIPass : Gfx::GraphExecutor
 	Gfx::Sampler sampler;
 	Gfx::Texture font_texture;
 	Slice<GuiGlyph> glyph_data;
-	FT_Face font_face;
+	// Unicode code point to FreeType glyph index
+	HashMap<U32, U32> const* glyph_indices;
 	Float2 viewport_size;
 	F32 dpi;
 	Slice<RenderItem const> render_items;
 
-	static UIPass& Build(Gfx::GraphBuilder& builder, Gfx::GraphTexture write_texture, Gfx::Pipeline pso, Gfx::Sampler sampler, Gfx::Texture font_texture, Float2 viewport_size, Slice<GuiGlyph> glyph_data, FT_Face font_face)
+	static UIPass& Build(Gfx::GraphBuilder& builder, Gfx::GraphTexture write_texture, Gfx::Pipeline pso, Gfx::Sampler sampler, Gfx::Texture font_texture, Float2 viewport_size, Slice<GuiGlyph> glyph_data, HashMap<U32, U32> const* glyph_indices)
 	{
-		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_STR("UI"));
+		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_SID("UI"));
 		UIPass& data = Gfx::GraphSetExecutor<UIPass>(builder, pass);
 		data.output = Gfx::GraphWriteTexture(builder, pass, write_texture, Gfx::Access::RenderTarget);
 		data.pso = pso;
@@ -183,7 +185,7 @@ struct UIPass : Gfx::GraphExecutor
 		data.font_texture = font_texture;
 		data.viewport_size = viewport_size;
 		data.glyph_data = glyph_data;
-		data.font_face = font_face;
+		data.glyph_indices = glyph_indices;
 		// #TODO: Handle dpi properly
 		data.dpi = 1.0f;
 		return data;
@@ -257,7 +259,9 @@ struct UIPass : Gfx::GraphExecutor
 				continue;
 			}
 
-			U32 const char_index = FT_Get_Char_Index(font_face, unicode);
+			// Code points the font doesn't have use glyph 0, same as FT_Get_Char_Index
+			U32 const* found_index = glyph_indices->Find(unicode);
+			U32 const char_index = found_index ? *found_index : 0;
 			GuiGlyph const& glyph = glyph_data[char_index];
 			bool is_space = false;
 			if (unicode < 128)
@@ -370,7 +374,7 @@ struct PresentPass : Gfx::GraphExecutor
 
 	static PresentPass const& Build(Gfx::GraphBuilder& builder, Gfx::GraphTexture backbuffer)
 	{
-		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_STR("Present"));
+		Gfx::GraphPass& pass = Gfx::GraphCreatePass(builder, PAW_SID("Present"));
 		PresentPass& data = Gfx::GraphSetExecutor<PresentPass>(builder, pass);
 		Gfx::GraphReadTexture(builder, pass, backbuffer, Gfx::Access::Present);
 		return data;
@@ -388,6 +392,7 @@ int main(int arg_count, char* args[])
 	ArenaAllocator static_allocator{};
 	ArenaAllocator debug_static_allocator{};
 	ArenaAllocator temp_allocator{};
+	temp_allocator.SetMemoryCategory(MemoryCategory::Temp);
 
 	Platform::Init(&static_allocator, &debug_static_allocator);
 
@@ -539,6 +544,15 @@ int main(int arg_count, char* args[])
 		}
 	}
 
+	HashMap<U32, U32> glyph_indices{&static_allocator, static_cast<S32>(font_face->num_glyphs)};
+	{
+		FT_UInt glyph_index = 0;
+		for (FT_ULong char_code = FT_Get_First_Char(font_face, &glyph_index); glyph_index != 0; char_code = FT_Get_Next_Char(font_face, char_code, &glyph_index))
+		{
+			glyph_indices.Set(static_cast<U32>(char_code), glyph_index);
+		}
+	}
+
 	Gfx::Texture font_texture = Gfx::CreateTexture(gfx_state, {
 																  .width = tex_size,
 																  .height = tex_size,
@@ -611,9 +625,9 @@ int main(int arg_count, char* args[])
 
 	Int2 const viewport_size = Platform::GetViewportSize();
 
-	SceneViewPass const& scene_view_pass = SceneViewPass::Build(graph_builder, PAW_STR("Scene View"), viewport_size.x, viewport_size.y, test_pso, {1.0f, 0.0f, 1.0f}, font_texture, sampler);
+	SceneViewPass const& scene_view_pass = SceneViewPass::Build(graph_builder, PAW_SID("Scene View"), viewport_size.x, viewport_size.y, test_pso, {1.0f, 0.0f, 1.0f}, font_texture, sampler);
 
-	UIPass& ui_pass = UIPass::Build(graph_builder, scene_view_pass.color_rt, ui_pso, sampler, font_texture, {static_cast<F32>(viewport_size.x), static_cast<F32>(viewport_size.y)}, glyph_data, font_face);
+	UIPass& ui_pass = UIPass::Build(graph_builder, scene_view_pass.color_rt, ui_pso, sampler, font_texture, {static_cast<F32>(viewport_size.x), static_cast<F32>(viewport_size.y)}, glyph_data, &glyph_indices);
 
 	BlitPass const& blit_to_backbuffer_pass = BlitPass::Build(graph_builder, backbuffer, ui_pass.output, sampler, blit_pso);
 	(void)blit_to_backbuffer_pass;
@@ -7,6 +7,8 @@
 #include <core/reflection.h>
 #include <core/slice.inl>
 #include <core/arena.h>
+#include <core/slab.h>
+#include <core/varray.h>
 #include <core/memory.inl>
 #include <core/src_location_types.h>
 
@@ -31,6 +33,8 @@ static Float4 argb(Byte a, Byte r, Byte g, Byte b)
 }
 
 static ArenaAllocator* g_widget_allocator = nullptr;
+// Widgets outlive the frame they were created in, unlike everything in g_widget_allocator
+static SlabAllocator* g_widget_node_allocator = nullptr;
 static Widget* g_current_parent = nullptr;
 static Widget* g_current_sibling = nullptr;
 
@@ -46,22 +50,21 @@ struct CursorInteractBox
 class WidgetContext : NonCopyable
 {
 public:
-	WidgetContext()
+	explicit WidgetContext(IAllocator* allocator)
+		: render_items(allocator)
+		, cursor_interact_boxes(allocator)
 	{
-	}
-
-	// #TODO: Move this back into the constructor when it's no longer a global
-	void init(IAllocator* allocator)
-	{
-		render_items = PAW_NEW_SLICE_IN(allocator, 4096, RenderItem);
-		cursor_interact_boxes = PAW_NEW_SLICE_IN(allocator, 512, CursorInteractBox);
+		render_items.GetArena()->SetMemoryCategory(MemoryCategory::UI);
+		cursor_interact_boxes.GetArena()->SetMemoryCategory(MemoryCategory::UI);
 	}
 
 	void frame_reset(Float2 root_clip_size)
 	{
 		current_clip_rect = {Float2{}, root_clip_size};
-		render_item_index = 1;
-		cursor_interact_box_index = 0;
+		// The first item is left as a default one
+		render_items.Clear();
+		render_items.PushBack();
+		cursor_interact_boxes.Clear();
 	}
 
 	void reset_mouse_move()
@@ -81,7 +84,7 @@ public:
 
 	void push_render_box(RenderBox&& box)
 	{
-		RenderItem& item = render_items[render_item_index++];
+		RenderItem& item = render_items.PushBack();
 		item.type = RenderItem::Type::Box;
 		item.box = box;
 		item.clip_rect = current_clip_rect;
@@ -89,7 +92,7 @@ public:
 
 	void push_render_line(RenderLine&& line)
 	{
-		RenderItem& item = render_items[render_item_index++];
+		RenderItem& item = render_items.PushBack();
 		item.type = RenderItem::Type::Line;
 		item.line = line;
 		item.clip_rect = current_clip_rect;
@@ -137,21 +140,21 @@ public:
 
 	Slice<RenderItem const> GetRenderItems()
 	{
-		return {render_items.items, render_item_index};
+		return render_items.GetItems();
 	}
 
 private:
-	Slice<RenderItem> render_items{nullptr, 0};
-	Slice<CursorInteractBox> cursor_interact_boxes{nullptr, 0};
+	// Both only ever commit what the busiest frame so far needed
+	VArray<RenderItem> render_items{};
+	VArray<CursorInteractBox> cursor_interact_boxes{};
 	Widget* current_frame_hovered_element_owner = nullptr;
-	S32 render_item_index = 0;
-	S32 cursor_interact_box_index = 0;
 	RenderClipRect current_clip_rect{};
 };
 
 static Widget* g_last_frame_hovered_element_owner = nullptr;
-static WidgetContext g_background_widget_context{};
-static WidgetContext g_foreground_widget_context{};
+// Created in UITest, each owns the arenas behind its item arrays
+static WidgetContext* g_background_widget_context = nullptr;
+static WidgetContext* g_foreground_widget_context = nullptr;
 static WidgetContext* g_widget_context = nullptr;
 static Widget* g_active_element_owner = nullptr;
 static Widget* g_just_clicked_element_owner = nullptr;
@@ -162,6 +165,11 @@ struct WidgetBuildContext;
 class ElementTree;
 static ElementTree* g_element_tree = nullptr;
 
+// The UI arenas are reset every frame, keep their pages committed unless they stay oversized for a couple of seconds
+static constexpr RetentionPolicy g_ui_retention_policy{
+	.decommit_after_frames = 120,
+};
+
 static PtrSize g_current_widget_id = g_null_widget_id;
 
 struct WidgetTempID
@@ -190,6 +198,8 @@ class ElementTree
 public:
 	ElementTree()
 	{
+		element_allocator.SetRetentionPolicy(g_ui_retention_policy);
+		element_allocator.SetMemoryCategory(MemoryCategory::UI);
 	}
 
 	template <typename ElementType, typename PropsType>
@@ -362,7 +372,7 @@ public:
 		if (widget == nullptr)
 		{
 			// widget = PAW_NEW_IN(g_widget_allocator, WidgetType)();
-			Widget* new_widget = new Widget();
+			Widget* new_widget = PAW_NEW_IN(g_widget_node_allocator, Widget)();
 			new_widget->debug_type_name = debug_type_name;
 			if constexpr (!stateless)
 			{
@@ -860,7 +870,7 @@ public:
 	void paint(Float2 offset, Float2 size) override
 	{
 		WidgetContext* previous_context = g_widget_context;
-		g_widget_context = &g_foreground_widget_context;
+		g_widget_context = g_foreground_widget_context;
 
 		Element::paint(offset, size);
 
@@ -2124,17 +2134,17 @@ Slice<RenderItem const> UIUpdate(Float2 ui_size)
 {
 	// fprintf(stdout, "==================== Frame Start =================\n");
 
-	g_last_frame_hovered_element_owner = g_foreground_widget_context.get_current_frame_hovered() != nullptr ? g_foreground_widget_context.get_current_frame_hovered() : g_background_widget_context.get_current_frame_hovered();
+	g_last_frame_hovered_element_owner = g_foreground_widget_context->get_current_frame_hovered() != nullptr ? g_foreground_widget_context->get_current_frame_hovered() : g_background_widget_context->get_current_frame_hovered();
 
-	g_foreground_widget_context.frame_reset(ui_size);
-	g_background_widget_context.frame_reset(ui_size);
-	g_widget_context = &g_background_widget_context;
+	g_foreground_widget_context->frame_reset(ui_size);
+	g_background_widget_context->frame_reset(ui_size);
+	g_widget_context = g_background_widget_context;
 
 	g_widget_allocator->FreeAll();
 	if (g_root == nullptr)
 	{
 		// RootWidget* root = PAW_NEW_IN(g_widget_allocator, RootWidget)();
-		g_root = new Widget();
+		g_root = PAW_NEW_IN(g_widget_node_allocator, Widget)();
 	}
 	g_current_parent = g_root;
 	g_current_sibling = nullptr;
@@ -2801,15 +2811,19 @@ Slice<RenderItem const> UIUpdate(Float2 ui_size)
 
 	// g_active_widget = nullptr;
 
-	return g_background_widget_context.GetRenderItems();
+	return g_background_widget_context->GetRenderItems();
 }
 
 void UITest(IAllocator* allocator)
 {
-	g_widget_allocator = PAW_NEW_IN(allocator, ArenaAllocator);
+	g_widget_allocator = PAW_NEW_IN(allocator, ArenaAllocator)();
+	g_widget_allocator->SetRetentionPolicy(g_ui_retention_policy);
+	g_widget_allocator->SetMemoryCategory(MemoryCategory::UI);
+	g_widget_node_allocator = PAW_NEW_IN(allocator, SlabAllocator)(sizeof(Widget), alignof(Widget));
+	g_widget_node_allocator->SetMemoryCategory(MemoryCategory::UI);
 
 	g_element_tree = PAW_NEW_IN(allocator, ElementTree)();
 
-	g_background_widget_context.init(allocator);
-	g_foreground_widget_context.init(allocator);
+	g_background_widget_context = PAW_NEW_IN(allocator, WidgetContext)(allocator);
+	g_foreground_widget_context = PAW_NEW_IN(allocator, WidgetContext)(allocator);
 }
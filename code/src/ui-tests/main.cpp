@@ -201,6 +201,11 @@ struct WidgetBuildContext;
 class ElementTree;
 static ElementTree* g_element_tree = nullptr;
 
+// The UI arenas are reset every frame, keep their pages committed unless they stay oversized for a couple of seconds
+static constexpr RetentionPolicy g_ui_retention_policy{
+	.decommit_after_frames = 120,
+};
+
 static PtrSize g_current_widget_id = g_null_widget_id;
 
 struct WidgetTempID
@@ -229,6 +234,8 @@ class ElementTree
 public:
 	ElementTree()
 	{
+		element_allocator.SetRetentionPolicy(g_ui_retention_policy);
+		element_allocator.SetMemoryCategory(MemoryCategory::UI);
 	}
 
 	template <typename ElementType, typename PropsType>
@@ -3006,6 +3013,8 @@ int main(int arg_count, char* args[])
 	(void)ints;
 	test_main(arg_count, args);
 	ArenaAllocator widget_allocator{};
+	widget_allocator.SetRetentionPolicy(g_ui_retention_policy);
+	widget_allocator.SetMemoryCategory(MemoryCategory::UI);
 	g_widget_allocator = &widget_allocator;
 
 	ElementTree element_tree{};